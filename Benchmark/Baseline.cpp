@@ -0,0 +1,214 @@
+/*****************************************************************//**
+ * \file   Baseline.cpp
+ * \brief
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+// std
+#include <sstream>
+
+// this
+#include "Baseline.hpp"
+
+namespace benchmark
+{
+    void BaselineTokenizer::Tokenize(std::string_view source, std::vector<std::string>& tokens)
+    {
+        mFileContents.assign(source);
+        mRemovedStrings.clear();
+        tokens.clear();
+
+        RemoveComments();
+        MaskStrings();
+        NormalizeSpaces();
+
+        std::stringstream fCs(mFileContents);
+        while (fCs >> tokens.emplace_back());
+
+        // the last extraction always fails on an empty token
+        tokens.pop_back();
+
+        RestoreStrings();
+    }
+
+    inline void BaselineTokenizer::RemoveComments()
+    {
+        bool inQuotes = false;
+        bool inCComment = false;
+        bool inCppComment = false;
+        bool nextLineComment = false;
+
+        for (size_t i = 0; i < mFileContents.length(); i++)
+        {
+            // comment start
+            if (mFileContents[i] == '/'
+                && (i + 1 < mFileContents.length())
+                && !inQuotes
+                && !(inCComment || inCppComment))
+            {
+                if (mFileContents[i + 1] == '*')
+                {
+                    inCComment = true;
+                }
+                else if (mFileContents[i + 1] == '/')
+                {
+                    inCppComment = true;
+                }
+            }
+
+            // quote start or end
+            else if (mFileContents[i] == '\"'
+                && (i != 0)
+                && (mFileContents[i - 1] != '\\')
+                && !(inCComment || inCppComment))
+            {
+                inQuotes = !inQuotes;
+            }
+
+            // c comment end
+            else if (mFileContents[i] == '*'
+                && (i + 1 < mFileContents.length())
+                && mFileContents[i + 1] == '/'
+                && inCComment
+                && !inCppComment
+                && !inQuotes)
+            {
+                inCComment = false;
+
+                mFileContents[i] = ' ';
+                mFileContents[i + 1] = ' ';
+            }
+
+            // cpp comment end
+            else if (mFileContents[i] == '\n'
+                && (i != 0)
+                && inCppComment
+                && !nextLineComment
+                && !inCComment
+                && !inQuotes)
+            {
+                inCppComment = false;
+            }
+
+            // cpp comment continued onto the next line
+            else if (mFileContents[i] == '\\'
+                && inCppComment
+                && !inCComment
+                && !inQuotes)
+            {
+                nextLineComment = true;
+            }
+
+            else if (mFileContents[i] != '\\'
+                && nextLineComment)
+            {
+                nextLineComment = false;
+            }
+
+            if (inCComment || inCppComment)
+            {
+                mFileContents[i] = ' ';
+            }
+        }
+    }
+
+    inline void BaselineTokenizer::MaskStrings()
+    {
+        bool inQuotes = false;
+        bool prev = false;
+
+        for (size_t i = 0; i < mFileContents.length(); i++)
+        {
+            prev = inQuotes;
+            if (mFileContents[i] == '"'
+                && i != 0
+                && mFileContents[i - 1] != '\\')
+            {
+                inQuotes = !inQuotes;
+            }
+
+            if (inQuotes && prev)
+            {
+                mRemovedStrings.push_back(mFileContents[i]);
+                mFileContents[i] = '$';
+            }
+        }
+    }
+
+    inline void BaselineTokenizer::RestoreStrings()
+    {
+        bool inQuotes = false;
+        bool prev = false;
+        size_t currentIndex = 0;
+
+        for (size_t i = 0; i < mFileContents.length(); i++)
+        {
+            prev = inQuotes;
+            if (mFileContents[i] == '"'
+                && i != 0
+                && mFileContents[i - 1] != '\\')
+            {
+                inQuotes = !inQuotes;
+            }
+
+            if (inQuotes && prev)
+            {
+                mFileContents[i] = mRemovedStrings[currentIndex];
+                currentIndex++;
+            }
+        }
+    }
+
+    inline void BaselineTokenizer::NormalizeSpaces()
+    {
+        AddPadding(";");
+        AddPadding("{");
+        AddPadding("}");
+        AddPadding("(");
+        AddPadding(")");
+        AddPadding("namespace");
+        AddPadding("struct");
+        AddPadding("class");
+        AddPadding("=");
+
+        // keywords
+        AddPadding("serializable");
+        AddPadding("printable");
+
+        RemoveExtraSpaces();
+    }
+
+    inline void BaselineTokenizer::AddPadding(std::string_view padword)
+    {
+        size_t location = 0;
+        while (true)
+        {
+            location = mFileContents.find(padword, location);
+
+            if (location == std::string::npos) break;
+
+            mFileContents.insert(location + padword.length(), " ");
+            mFileContents.insert(location, " ");
+
+            location += 2;
+        }
+    }
+
+    inline void BaselineTokenizer::RemoveExtraSpaces()
+    {
+        char previous = '\0';
+        for (size_t i = 0; i < mFileContents.size();)
+        {
+            if ((previous == ' ' || previous == '\t') && mFileContents[i] == ' ')
+            {
+                mFileContents.erase(i, 1);
+                continue;
+            }
+
+            previous = mFileContents[i];
+            i++;
+        }
+    }
+} // namespace benchmark
@@ -0,0 +1,50 @@
+/*****************************************************************//**
+ * \file   Baseline.hpp
+ * \brief  the text rewriting front end the preprocessor started with,
+ *         kept so the lexer can be measured against it on the same
+ *         corpus. it blanks comments, pads every structural character
+ *         and keyword with spaces and splits on whitespace with a
+ *         stringstream
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace benchmark
+{
+	class BaselineTokenizer
+	{
+	public:
+		// copies source and rewrites the copy, tokens are cleared first
+		void Tokenize(std::string_view source, std::vector<std::string>& tokens);
+
+	private:
+		// replaces every character of a comment with a space
+		inline void RemoveComments();
+
+		// replaces the inside of every string with '$' so padding never touches it
+		inline void MaskStrings();
+
+		// undoes MaskStrings, the tokens keep the masked text just like they used to
+		inline void RestoreStrings();
+
+		// surrounds structural characters and keywords with spaces then collapses runs of spaces
+		inline void NormalizeSpaces();
+
+		inline void AddPadding(std::string_view padword);
+
+		inline void RemoveExtraSpaces();
+
+	private:
+		std::string mFileContents;
+
+		std::string mRemovedStrings;
+	};
+} // namespace benchmark
@@ -0,0 +1,228 @@
+/*****************************************************************//**
+ * \file   Corpus.cpp
+ * \brief
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+// std
+#include <cctype>
+#include <fstream>
+
+// this
+#include "Corpus.hpp"
+
+namespace benchmark
+{
+    namespace
+    {
+        // the mix of field types found in real headers
+        constexpr std::string_view sFieldTypes[] =
+        {
+            "int", "float", "double", "bool", "unsigned", "size_t", "char",
+            "std::string", "std::vector<int>", "std::vector<float>", "std::vector<std::string>",
+        };
+
+        // literals that contain what a naive scanner would mistake for comments, braces or semicolons
+        constexpr std::string_view sLiterals[] =
+        {
+            "\"plain text\"",
+            "\"// not a comment\"",
+            "\"/* still not a comment */\"",
+            "\"braces { } and ; inside\"",
+            "\"escaped \\\"quotes\\\" here\"",
+            "R\"(raw \"text\" with ) inside)\"",
+        };
+    }
+
+    CorpusGenerator::CorpusGenerator(std::vector<std::string> names, const CorpusOptions& options)
+        : mNames(std::move(names))
+        , mOptions(options)
+    {
+        if (mNames.empty()) mNames.push_back("Name");
+    }
+
+    bool CorpusGenerator::LoadNames(const std::filesystem::path& path, std::vector<std::string>& names)
+    {
+        std::ifstream file(path);
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            // names like Ann-Marie become AnnMarie
+            std::string name;
+            for (const char c : line)
+            {
+                if (std::isalnum(static_cast<unsigned char>(c))) name.push_back(c);
+            }
+
+            if (!name.empty() && !std::isdigit(static_cast<unsigned char>(name[0]))) names.push_back(name);
+        }
+
+        return !names.empty();
+    }
+
+    std::vector<std::filesystem::path> CorpusGenerator::Write(const std::filesystem::path& directory)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+
+        std::vector<std::filesystem::path> files;
+        files.reserve(mOptions.mFileCount);
+
+        std::string output;
+        for (size_t i = 0; i < mOptions.mFileCount; i++)
+        {
+            const std::string name = "h" + std::to_string(i);
+            Generate(name, i, mOptions.mFileSize, output);
+
+            const std::filesystem::path path = directory / (name + ".hpp");
+            std::ofstream file(path, std::ios::binary);
+            file.write(output.data(), static_cast<std::streamsize>(output.size()));
+
+            files.push_back(path);
+        }
+
+        return files;
+    }
+
+    void CorpusGenerator::Generate(std::string_view name, size_t index, size_t size, std::string& output)
+    {
+        mRandom.seed(mOptions.mSeed * 0x9E3779B97F4A7C15ull + index);
+
+        const bool isReflected = Chance(mOptions.mReflectedFiles);
+
+        output.clear();
+        output.reserve(size + 1024);
+
+        output += "/*****************************************************************//**\n";
+        output += " * \\file   "; output += name; output += ".hpp\n";
+        output += " * \\brief  generated by the benchmark\n";
+        output += " *********************************************************************/\n\n";
+        output += "#pragma once\n\n";
+        if (isReflected) output += "#include <Reflection.hpp>\n";
+        output += "#include <string>\n#include <vector>\n\n";
+
+        // grows a namespace at a time so large files keep the same shape as small ones
+        while (output.size() < size)
+        {
+            AddNamespace(output, 0, mRandom() % 3, isReflected);
+            output += '\n';
+        }
+
+        if (isReflected)
+        {
+            output += "#include <.meta/"; output += name; output += ".meta>\n";
+        }
+    }
+
+    const std::string& CorpusGenerator::GetName()
+    {
+        return mNames[mRandom() % mNames.size()];
+    }
+
+    bool CorpusGenerator::Chance(double probability)
+    {
+        return std::uniform_real_distribution<double>(0.0, 1.0)(mRandom) < probability;
+    }
+
+    void CorpusGenerator::AddNamespace(std::string& output, size_t indent, size_t depth, bool isReflected)
+    {
+        if (Chance(0.3)) AddComment(output, indent);
+
+        Indent(output, indent);
+        output += "namespace "; output += GetName(); output += '\n';
+        Indent(output, indent);
+        output += "{\n";
+
+        if (depth > 0)
+        {
+            AddNamespace(output, indent + 1, depth - 1, isReflected);
+        }
+        else
+        {
+            const size_t classCount = 1 + mRandom() % 3;
+            for (size_t i = 0; i < classCount; i++) AddClass(output, indent + 1, isReflected);
+        }
+
+        Indent(output, indent);
+        output += "}\n";
+    }
+
+    void CorpusGenerator::AddClass(std::string& output, size_t indent, bool isReflected)
+    {
+        const std::string& className = GetName();
+
+        AddComment(output, indent);
+        Indent(output, indent);
+        output += Chance(0.5) ? "class " : "struct ";
+        output += className; output += '\n';
+        Indent(output, indent);
+        output += "{\n";
+        Indent(output, indent);
+        output += "public:\n";
+
+        Indent(output, indent + 1);
+        output += className; output += "() = default;\n\n";
+
+        // methods have bodies with braces and literals the collector has to step over
+        const size_t methodCount = mRandom() % 3;
+        for (size_t i = 0; i < methodCount; i++)
+        {
+            Indent(output, indent + 1);
+            output += "const char* Get"; output += GetName(); output += "() const { return ";
+            output += sLiterals[mRandom() % std::size(sLiterals)]; output += "; }\n";
+        }
+
+        if (methodCount) output += '\n';
+
+        Indent(output, indent);
+        output += "private:\n";
+
+        const size_t fieldCount = 2 + mRandom() % 8;
+        for (size_t i = 0; i < fieldCount; i++)
+        {
+            const std::string_view type = sFieldTypes[mRandom() % std::size(sFieldTypes)];
+
+            if (Chance(0.15)) AddComment(output, indent + 1);
+
+            Indent(output, indent + 1);
+            if (isReflected && Chance(mOptions.mFieldDensity)) output += Chance(0.5) ? "printable " : "serializable ";
+
+            output += type; output += " m"; output += GetName();
+
+            // strings sometimes start out with a tricky literal
+            if (type == "std::string" && Chance(0.5))
+            {
+                output += " = "; output += sLiterals[mRandom() % std::size(sLiterals)];
+            }
+
+            output += ";\n";
+        }
+
+        Indent(output, indent);
+        output += "};\n\n";
+    }
+
+    void CorpusGenerator::AddComment(std::string& output, size_t indent)
+    {
+        Indent(output, indent);
+
+        if (Chance(0.5))
+        {
+            output += "// "; output += GetName(); output += ' '; output += GetName(); output += " { not code; }\n";
+        }
+        else
+        {
+            output += "/* "; output += GetName(); output += "\n";
+            Indent(output, indent);
+            output += " * \""; output += GetName(); output += "\" // nested */\n";
+        }
+    }
+
+    void CorpusGenerator::Indent(std::string& output, size_t indent)
+    {
+        output.append(indent, '\t');
+    }
+}
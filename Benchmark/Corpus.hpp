@@ -0,0 +1,77 @@
+/*****************************************************************//**
+ * \file   Corpus.hpp
+ * \brief  generates synthetic headers that look like real ones, nested
+ *         namespaces, classes with methods, comments, literals and
+ *         reflected fields. the same seed always generates the same
+ *         corpus so runs can be compared against a baseline
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace benchmark
+{
+	struct CorpusOptions
+	{
+		size_t mFileCount = 10000;
+
+		// headers are grown a class at a time until they reach this many bytes
+		size_t mFileSize = 4096;
+
+		// the fraction of headers that include Reflection.hpp, the rest are ruled out by the prefilter
+		double mReflectedFiles = 0.5;
+
+		// the fraction of fields in a reflected header that are printable or serializable
+		double mFieldDensity = 0.5;
+
+		uint64_t mSeed = 1;
+	};
+
+	class CorpusGenerator
+	{
+	public:
+		// names are used for every identifier
+		CorpusGenerator(std::vector<std::string> names, const CorpusOptions& options);
+
+		// reads one name per line keeping only the characters an identifier can use, false if nothing was read
+		static bool LoadNames(const std::filesystem::path& path, std::vector<std::string>& names);
+
+		// writes every header of the corpus into directory as h0.hpp, h1.hpp... and returns their paths
+		std::vector<std::filesystem::path> Write(const std::filesystem::path& directory);
+
+		// generates the header called name, index picks its seed so every header is independent of the others
+		void Generate(std::string_view name, size_t index, size_t size, std::string& output);
+
+	private:
+		inline const std::string& GetName();
+
+		inline bool Chance(double probability);
+
+		// a namespace holding one to three classes, nested up to depth more times
+		inline void AddNamespace(std::string& output, size_t indent, size_t depth, bool isReflected);
+
+		inline void AddClass(std::string& output, size_t indent, bool isReflected);
+
+		// a line or block comment, never containing a keyword
+		inline void AddComment(std::string& output, size_t indent);
+
+		static inline void Indent(std::string& output, size_t indent);
+
+	private:
+		std::vector<std::string> mNames;
+
+		CorpusOptions mOptions;
+
+		std::mt19937_64 mRandom;
+	};
+} // namespace benchmark
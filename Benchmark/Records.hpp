@@ -0,0 +1,52 @@
+/*****************************************************************//**
+ * \file   Records.hpp
+ * \brief  reflected types the serialize suite writes and reads back,
+ *         a mix of strings, numbers, containers and a nested class like
+ *         a saved game entity
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <map>
+#include <string>
+#include <vector>
+
+#include <Reflection.hpp>
+
+namespace benchmark
+{
+	class Stats
+	{
+	public:
+		serializable int mStrength = 0;
+		serializable int mAgility = 0;
+		serializable float mSpeed = 0;
+		serializable float mRange = 0;
+	};
+
+	class Record
+	{
+	public:
+		serializable std::string mName;
+		serializable uint64_t mId = 0;
+		serializable int mLevel = 0;
+		serializable bool mIsAlive = false;
+
+		// adjacent floats, the binary codec copies them in one run
+		serializable float mX = 0;
+		serializable float mY = 0;
+		serializable float mZ = 0;
+		serializable double mHealth = 0;
+
+		serializable Stats mStats;
+		serializable std::vector<int> mInventory;
+		serializable std::vector<float> mSamples;
+		serializable std::map<std::string, int> mCounters;
+	};
+} // namespace benchmark
+
+#include <.meta/Records.meta>
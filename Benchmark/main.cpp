@@ -0,0 +1,761 @@
+/*****************************************************************//**
+ * \file   main.cpp
+ * \brief  generates a synthetic corpus, runs the preprocessor over it and
+ *         compares the throughput against a saved baseline
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+// std
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// simdjson
+#include <simdjson.h>
+
+#include <OutStream.hpp>
+
+// preprocessor
+#include "Batch.hpp"
+#include "Classifier.hpp"
+#include "Interner.hpp"
+#include "Lexer.hpp"
+#include "Prefilter.hpp"
+#include "Profiler.hpp"
+#include "Timer.hpp"
+
+// this
+#include "Baseline.hpp"
+#include "Corpus.hpp"
+#include "Records.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <Psapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "Psapi.lib")
+#endif
+#else
+#include <sys/resource.h>
+#endif
+
+namespace benchmark
+{
+    namespace
+    {
+        // bump whenever metrics are renamed or measured differently
+        constexpr int sBaselineVersion = 1;
+
+        struct Options
+        {
+            CorpusOptions mCorpus;
+
+            // workers for the pipeline suite, 0 uses every hardware thread
+            size_t mThreadCount = 0;
+
+            // every measurement keeps its fastest repetition
+            size_t mRepeatCount = 3;
+
+            std::filesystem::path mNamesPath;
+            std::filesystem::path mCorpusPath = "benchmark_corpus";
+            std::filesystem::path mBaselinePath = "benchmark_baseline.json";
+
+            // writes the results as the new baseline instead of comparing against it
+            bool mIsSaving = false;
+
+            // percent of throughput a metric may lose before the run fails
+            double mThreshold = 10.0;
+
+            // pipeline, kernels, baseline, sizes, threads and serialize, empty runs all of them
+            std::vector<std::string> mSuites;
+        };
+
+        struct Metric
+        {
+            std::string mName;
+            double mValue;
+            const char* mUnit;
+
+            // only throughput is compared against the baseline, higher is better
+            bool mIsThroughput;
+        };
+
+        constexpr double sMegabyte = 1024.0 * 1024.0;
+
+        bool IsSuiteEnabled(const Options& options, std::string_view suite)
+        {
+            return options.mSuites.empty() || std::find(options.mSuites.begin(), options.mSuites.end(), suite) != options.mSuites.end();
+        }
+
+        size_t GetHardwareThreads()
+        {
+            return std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+
+        uint64_t GetPeakMemory()
+        {
+#ifdef _WIN32
+            PROCESS_MEMORY_COUNTERS counters = {};
+            if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+
+            return counters.PeakWorkingSetSize;
+#else
+            rusage usage = {};
+            if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+
+#ifdef __APPLE__
+            return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+            // kilobytes everywhere but mac
+            return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+        }
+
+        uint64_t GetTotalSize(const std::vector<std::filesystem::path>& files)
+        {
+            uint64_t bytes = 0;
+            for (const std::filesystem::path& file : files)
+            {
+                std::error_code error;
+                bytes += std::filesystem::file_size(file, error);
+            }
+
+            return bytes;
+        }
+
+        // the next run starts without any meta files or cache like a clean checkout
+        void RemoveMeta()
+        {
+            std::error_code error;
+            std::filesystem::remove_all(".meta", error);
+        }
+
+        // preprocesses files with a fresh batch like a new process would, returns the seconds it took
+        double RunPipeline(const std::vector<std::filesystem::path>& files, size_t threadCount, bool isCold)
+        {
+            if (isCold) RemoveMeta();
+
+            gep::Batch batch(threadCount);
+            batch.GetPreprocessor().InitializeMetaHeader();
+
+            // the per file messages are still built, just never printed
+            std::ostream discard(nullptr);
+
+            gep::Timer timer;
+            timer.Start();
+
+            batch.Run(files, discard);
+            batch.GetPreprocessor().FlushCache();
+
+            return timer.Stop();
+        }
+
+        // the fastest of several runs, stage totals are kept from the fastest
+        double RunPipelineBest(const Options& options, const std::vector<std::filesystem::path>& files, size_t threadCount, bool isCold, gep::StageTotals& totals)
+        {
+            double best = 0;
+            for (size_t i = 0; i < options.mRepeatCount; i++)
+            {
+                // a warm run needs the cache filled by a cold one first
+                if (!isCold && i == 0) RunPipeline(files, threadCount, true);
+
+                gep::Profiler::Reset();
+                const double seconds = RunPipeline(files, threadCount, isCold);
+
+                if (i == 0 || seconds < best)
+                {
+                    best = seconds;
+                    totals = gep::Profiler::GetTotals();
+                }
+            }
+
+            return best;
+        }
+
+        void PrintStages(const gep::StageTotals& totals)
+        {
+            for (size_t i = 0; i < totals.size(); i++)
+            {
+                const gep::StageStats& stats = totals[i];
+                if (stats.mCalls == 0) continue;
+
+                gep::cout << "  " << std::left << std::setw(12) << gep::Profiler::GetStageName(static_cast<gep::Stage>(i)) << std::right
+                          << std::fixed << std::setprecision(3) << std::setw(12) << stats.mMicroseconds / 1000.0 << " ms" << std::defaultfloat << std::endl;
+            }
+        }
+
+        void RunPipelineSuite(const Options& options, const std::vector<std::filesystem::path>& files, uint64_t bytes, std::vector<Metric>& metrics)
+        {
+            const size_t threadCount = options.mThreadCount ? options.mThreadCount : GetHardwareThreads();
+
+            for (const bool isCold : { true, false })
+            {
+                gep::StageTotals totals;
+                const double seconds = RunPipelineBest(options, files, threadCount, isCold, totals);
+
+                const std::string name = isCold ? "pipeline_cold" : "pipeline_warm";
+                metrics.push_back({ name + "_mb_per_s", bytes / sMegabyte / seconds, "MB/s", true });
+                metrics.push_back({ name + "_files_per_s", files.size() / seconds, "files/s", true });
+
+                gep::cout << (isCold ? "Cold" : "Warm") << " run with " << threadCount << " threads, time in each stage summed over threads:" << std::endl;
+                PrintStages(totals);
+            }
+        }
+
+        void RunKernelSuite(const Options& options, const std::vector<std::filesystem::path>& files, std::vector<Metric>& metrics)
+        {
+            // every header back to back, capped so the masks and tokens stay a reasonable size
+            constexpr size_t maxBytes = 256ull * 1024 * 1024;
+
+            std::string buffer;
+            std::vector<size_t> fileEnds;
+            for (const std::filesystem::path& file : files)
+            {
+                std::ifstream stream(file, std::ios::binary);
+                buffer.append(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+                fileEnds.push_back(buffer.size());
+
+                if (buffer.size() > maxBytes) break;
+            }
+
+            const std::string_view source(buffer);
+
+            // the prefilter runs once per file and stops at the first keyword like it does in the pipeline
+            gep::Prefilter prefilter;
+            double best = 0;
+            for (size_t repeat = 0; repeat < options.mRepeatCount; repeat++)
+            {
+                gep::Timer timer;
+                timer.Start();
+
+                size_t reflected = 0;
+                size_t start = 0;
+                for (const size_t end : fileEnds)
+                {
+                    reflected += prefilter.MayContainKeyword(source.substr(start, end - start));
+                    start = end;
+                }
+
+                const double seconds = timer.Stop();
+                if (repeat == 0 || seconds < best) best = seconds;
+
+                // keeps the loop from being optimized away
+                if (reflected > fileEnds.size()) std::abort();
+            }
+            metrics.push_back({ std::string("prefilter_") + prefilter.GetKernelName() + "_mb_per_s", source.size() / sMegabyte / best, "MB/s", true });
+
+            gep::Classifier classifier;
+            gep::SourceMasks masks;
+            best = 0;
+            for (size_t repeat = 0; repeat < options.mRepeatCount; repeat++)
+            {
+                gep::Timer timer;
+                timer.Start();
+                classifier.Classify(source, masks);
+
+                const double seconds = timer.Stop();
+                if (repeat == 0 || seconds < best) best = seconds;
+            }
+            metrics.push_back({ std::string("classify_") + classifier.GetKernelName() + "_mb_per_s", source.size() / sMegabyte / best, "MB/s", true });
+
+            std::vector<gep::Token> tokens;
+            std::vector<gep::TokenKind> kinds;
+            std::vector<gep::IncludeDirective> includes;
+            best = 0;
+            for (size_t repeat = 0; repeat < options.mRepeatCount; repeat++)
+            {
+                tokens.clear();
+                kinds.clear();
+                includes.clear();
+
+                gep::Timer timer;
+                timer.Start();
+                gep::Lexer lexer(source, masks);
+                lexer.Tokenize(tokens, kinds, includes);
+
+                const double seconds = timer.Stop();
+                if (repeat == 0 || seconds < best) best = seconds;
+            }
+            metrics.push_back({ "tokenize_mb_per_s", source.size() / sMegabyte / best, "MB/s", true });
+            metrics.push_back({ "tokenize_tokens_per_s", tokens.size() / best, "tokens/s", true });
+
+            // what interning saves over one std::string per identifier
+            gep::Interner interner;
+            size_t identifiers = 0;
+            size_t stringBytes = 0;
+            for (size_t i = 0; i < tokens.size(); i++)
+            {
+                if (kinds[i] != gep::TokenKind::Identifier) continue;
+
+                interner.Intern(tokens[i]);
+                identifiers++;
+
+                // short strings live inside of the string object
+                stringBytes += sizeof(std::string) + (tokens[i].size() > 15 ? tokens[i].size() + 1 : 0);
+            }
+            metrics.push_back({ "interner_strings", static_cast<double>(interner.GetCount()), "strings", false });
+            metrics.push_back({ "interner_mb", interner.GetMemoryUsage() / sMegabyte, "MB", false });
+            metrics.push_back({ "interner_naive_mb", stringBytes / sMegabyte, "MB", false });
+
+            gep::cout << "Kernels ran over " << source.size() / sMegabyte << " MB, " << identifiers << " identifiers interned into "
+                      << interner.GetCount() << " strings" << std::endl;
+        }
+
+        // the front end the preprocessor started with against the classifier and lexer, file by file over the same headers
+        void RunBaselineSuite(const Options& options, const std::vector<std::filesystem::path>& files, std::vector<Metric>& metrics)
+        {
+            // both sides read from memory so only the tokenizing is measured
+            std::vector<std::string> sources;
+            uint64_t bytes = 0;
+            for (const std::filesystem::path& file : files)
+            {
+                std::ifstream stream(file, std::ios::binary);
+                bytes += sources.emplace_back(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()).size();
+            }
+
+            BaselineTokenizer baseline;
+            std::vector<std::string> baselineTokens;
+            size_t baselineCount = 0;
+            double baselineBest = 0;
+            for (size_t repeat = 0; repeat < options.mRepeatCount; repeat++)
+            {
+                baselineCount = 0;
+
+                gep::Timer timer;
+                timer.Start();
+                for (const std::string& source : sources)
+                {
+                    baseline.Tokenize(source, baselineTokens);
+                    baselineCount += baselineTokens.size();
+                }
+
+                const double seconds = timer.Stop();
+                if (repeat == 0 || seconds < baselineBest) baselineBest = seconds;
+            }
+
+            gep::Classifier classifier;
+            gep::SourceMasks masks;
+            std::vector<gep::Token> tokens;
+            std::vector<gep::TokenKind> kinds;
+            std::vector<gep::IncludeDirective> includes;
+            size_t lexerCount = 0;
+            double lexerBest = 0;
+            for (size_t repeat = 0; repeat < options.mRepeatCount; repeat++)
+            {
+                lexerCount = 0;
+
+                gep::Timer timer;
+                timer.Start();
+                for (const std::string& source : sources)
+                {
+                    tokens.clear();
+                    kinds.clear();
+                    includes.clear();
+
+                    classifier.Classify(source, masks);
+                    gep::Lexer lexer(source, masks);
+                    lexer.Tokenize(tokens, kinds, includes);
+                    lexerCount += tokens.size();
+                }
+
+                const double seconds = timer.Stop();
+                if (repeat == 0 || seconds < lexerBest) lexerBest = seconds;
+            }
+
+            metrics.push_back({ "baseline_tokenize_mb_per_s", bytes / sMegabyte / baselineBest, "MB/s", true });
+            metrics.push_back({ "lexer_tokenize_mb_per_s", bytes / sMegabyte / lexerBest, "MB/s", true });
+            metrics.push_back({ "lexer_speedup", baselineBest / lexerBest, "x", false });
+
+            gep::cout << "Baseline made " << baselineCount << " tokens and the lexer " << lexerCount << " out of " << bytes / sMegabyte
+                      << " MB, the lexer is " << std::fixed << std::setprecision(2) << baselineBest / lexerBest << "x as fast" << std::defaultfloat << std::endl;
+        }
+
+        void RunSizeSuite(const Options& options, const std::vector<std::string>& names, std::vector<Metric>& metrics)
+        {
+            // every size is reflected so each one goes through the whole pipeline
+            CorpusOptions corpusOptions = options.mCorpus;
+            corpusOptions.mReflectedFiles = 1.0;
+            CorpusGenerator generator(names, corpusOptions);
+
+            const std::pair<const char*, size_t> sizes[] =
+            {
+                { "10kb", 10ull * 1024 }, { "100kb", 100ull * 1024 }, { "1mb", 1024ull * 1024 },
+                { "10mb", 10ull * 1024 * 1024 }, { "50mb", 50ull * 1024 * 1024 },
+            };
+
+            std::string contents;
+            for (size_t i = 0; i < std::size(sizes); i++)
+            {
+                const std::string name = std::string("size_") + sizes[i].first;
+                generator.Generate(name, options.mCorpus.mFileCount + i, sizes[i].second, contents);
+
+                const std::filesystem::path path = name + ".hpp";
+                {
+                    std::ofstream file(path, std::ios::binary);
+                    file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+                }
+
+                double best = 0;
+                for (size_t repeat = 0; repeat < options.mRepeatCount; repeat++)
+                {
+                    const double seconds = RunPipeline({ path }, 1, true);
+                    if (repeat == 0 || seconds < best) best = seconds;
+                }
+
+                metrics.push_back({ name + "_mb_per_s", contents.size() / sMegabyte / best, "MB/s", true });
+
+                std::error_code error;
+                std::filesystem::remove(path, error);
+            }
+        }
+
+        void RunThreadSuite(const Options& options, const std::vector<std::filesystem::path>& files, std::vector<Metric>& metrics)
+        {
+            // powers of two up to every hardware thread, which is always measured
+            std::vector<size_t> counts;
+            for (size_t count = 1; count < GetHardwareThreads(); count *= 2) counts.push_back(count);
+            counts.push_back(GetHardwareThreads());
+
+            double single = 0;
+            for (const size_t count : counts)
+            {
+                gep::StageTotals totals;
+                const double seconds = RunPipelineBest(options, files, count, true, totals);
+                if (count == 1) single = seconds;
+
+                metrics.push_back({ "threads_" + std::to_string(count) + "_files_per_s", files.size() / seconds, "files/s", true });
+
+                gep::cout << "-j " << count << ": " << std::fixed << std::setprecision(2) << single / seconds << std::defaultfloat << "x the speed of -j 1" << std::endl;
+            }
+        }
+
+        // the same records go through json and the binary codec, so records per second compares the two directly
+        void RunSerializeSuite(const Options& options, const std::vector<std::string>& names, std::vector<Metric>& metrics)
+        {
+            constexpr size_t recordCount = 100000;
+
+            std::mt19937_64 random(options.mCorpus.mSeed);
+            std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+
+            std::vector<Record> records(recordCount);
+            for (Record& record : records)
+            {
+                record.mName = names[random() % names.size()];
+                record.mId = random();
+                record.mLevel = static_cast<int>(random() % 100);
+                record.mIsAlive = random() & 1;
+                record.mX = position(random);
+                record.mY = position(random);
+                record.mZ = position(random);
+                record.mHealth = position(random) / 10.0;
+                record.mStats.mStrength = static_cast<int>(random() % 20);
+                record.mStats.mAgility = static_cast<int>(random() % 20);
+                record.mStats.mSpeed = position(random) / 100.0f;
+                record.mStats.mRange = position(random) / 100.0f;
+
+                for (size_t i = random() % 16; i > 0; i--) record.mInventory.push_back(static_cast<int>(random() % 2000) - 1000);
+                for (size_t i = random() % 8; i > 0; i--) record.mSamples.push_back(position(random));
+                for (size_t i = random() % 4; i > 0; i--) record.mCounters[names[random() % names.size()]] = static_cast<int>(random() % 500);
+            }
+
+            // the fastest of every repetition, false if any of them failed
+            const auto measure = [&](double& best, auto&& run)
+            {
+                bool isValid = true;
+                for (size_t repeat = 0; repeat < options.mRepeatCount; repeat++)
+                {
+                    gep::Timer timer;
+                    timer.Start();
+                    isValid &= run();
+
+                    const double seconds = timer.Stop();
+                    if (repeat == 0 || seconds < best) best = seconds;
+                }
+
+                return isValid;
+            };
+
+            gep::json::File json;
+            gep::binary::Encoder encoder;
+            gep::binary::Decoder decoder;
+            std::vector<Record> decoded;
+
+            double jsonWrite = 0, jsonRead = 0, binaryEncode = 0, binaryDecode = 0;
+            bool isValid = measure(jsonWrite, [&] { json.Clear(); json.Write(records); return true; });
+
+            json.Parse(json.GetOutput());
+            isValid &= measure(jsonRead, [&] { return json.Read(decoded); }) && decoded.size() == recordCount;
+
+            isValid &= measure(binaryEncode, [&] { encoder.Clear(); encoder.Encode(records); return true; });
+            isValid &= measure(binaryDecode, [&] { decoder.SetInput(encoder.GetOutput()); return decoder.Decode(decoded); }) && decoded.size() == recordCount;
+
+            if (!isValid)
+            {
+                gep::cerr << "The serialize suite failed to read back its own records" << std::endl;
+                return;
+            }
+
+            metrics.push_back({ "serialize_json_write_records_per_s", recordCount / jsonWrite, "records/s", true });
+            metrics.push_back({ "serialize_json_read_records_per_s", recordCount / jsonRead, "records/s", true });
+            metrics.push_back({ "serialize_binary_encode_records_per_s", recordCount / binaryEncode, "records/s", true });
+            metrics.push_back({ "serialize_binary_decode_records_per_s", recordCount / binaryDecode, "records/s", true });
+            metrics.push_back({ "serialize_json_mb", json.GetOutput().size() / sMegabyte, "MB", false });
+            metrics.push_back({ "serialize_binary_mb", encoder.GetOutput().size() / sMegabyte, "MB", false });
+
+            gep::cout << "Binary is " << std::fixed << std::setprecision(2) << jsonWrite / binaryEncode << "x as fast to write and "
+                      << jsonRead / binaryDecode << "x as fast to read as json at " << 100.0 * encoder.GetOutput().size() / json.GetOutput().size()
+                      << "% of the size" << std::defaultfloat << std::endl;
+        }
+
+        void PrintMetrics(const std::vector<Metric>& metrics)
+        {
+            for (const Metric& metric : metrics)
+            {
+                gep::cout << std::left << std::setw(36) << metric.mName << std::right << std::fixed << std::setprecision(2)
+                          << std::setw(16) << metric.mValue << ' ' << metric.mUnit << std::defaultfloat << std::endl;
+            }
+        }
+
+        void WriteCorpus(std::ostream& os, const CorpusOptions& corpus)
+        {
+            os << "{\"files\":" << corpus.mFileCount << ",\"size\":" << corpus.mFileSize << std::setprecision(17)
+               << ",\"reflected\":" << corpus.mReflectedFiles << ",\"density\":" << corpus.mFieldDensity << ",\"seed\":" << corpus.mSeed << "}";
+        }
+
+        bool SaveBaseline(const std::filesystem::path& path, const Options& options, const std::vector<Metric>& metrics)
+        {
+            std::ofstream file(path, std::ios::binary);
+            if (!file) return false;
+
+            file << "{\n  \"version\": " << sBaselineVersion << ",\n  \"corpus\": ";
+            WriteCorpus(file, options.mCorpus);
+            file << ",\n  \"metrics\":\n  {";
+
+            for (size_t i = 0; i < metrics.size(); i++)
+            {
+                file << (i ? ",\n" : "\n") << "    \"" << metrics[i].mName << "\": " << std::setprecision(17) << metrics[i].mValue;
+            }
+
+            file << "\n  }\n}\n";
+
+            return static_cast<bool>(file.flush());
+        }
+
+        // returns the number of metrics that lost more than the threshold, or -1 if the baseline could not be used
+        int CompareBaseline(const std::filesystem::path& path, const Options& options, const std::vector<Metric>& metrics)
+        {
+            simdjson::dom::parser parser;
+            simdjson::dom::element root;
+            if (parser.load(path.string()).get(root))
+            {
+                gep::cerr << "Failed to parse the baseline " << path << std::endl;
+                return -1;
+            }
+
+            int64_t version = 0;
+            if (root["version"].get(version) || version != sBaselineVersion)
+            {
+                gep::cwar << "The baseline is from another version of the benchmark, save a new one with -save" << std::endl;
+                return -1;
+            }
+
+            // numbers from a different corpus say nothing about a regression
+            simdjson::dom::object corpus;
+            uint64_t fileCount = 0, fileSize = 0, seed = 0;
+            double reflectedFiles = -1, fieldDensity = -1;
+
+            const bool isSameCorpus = !root["corpus"].get(corpus)
+                                   && !corpus["files"].get(fileCount) && fileCount == options.mCorpus.mFileCount
+                                   && !corpus["size"].get(fileSize) && fileSize == options.mCorpus.mFileSize
+                                   && !corpus["reflected"].get(reflectedFiles) && reflectedFiles == options.mCorpus.mReflectedFiles
+                                   && !corpus["density"].get(fieldDensity) && fieldDensity == options.mCorpus.mFieldDensity
+                                   && !corpus["seed"].get(seed) && seed == options.mCorpus.mSeed;
+            if (!isSameCorpus)
+            {
+                gep::cwar << "The baseline was saved with a different corpus, run with the same options or save a new one with -save" << std::endl;
+                return -1;
+            }
+
+            simdjson::dom::object saved;
+            if (root["metrics"].get(saved))
+            {
+                gep::cerr << "The baseline has no metrics" << std::endl;
+                return -1;
+            }
+
+            int regressions = 0;
+            for (const Metric& metric : metrics)
+            {
+                double before = 0;
+                if (!metric.mIsThroughput || saved[metric.mName].get(before) || before <= 0) continue;
+
+                const double change = 100.0 * (metric.mValue - before) / before;
+                const bool isRegression = change < -options.mThreshold;
+                if (isRegression) regressions++;
+
+                gep::ostream& os = isRegression ? gep::cerr : gep::cout;
+                os << std::left << std::setw(36) << metric.mName << std::right << std::fixed << std::setprecision(2)
+                   << std::setw(16) << before << " -> " << std::setw(12) << metric.mValue << std::showpos << std::setw(10) << change << '%'
+                   << std::noshowpos << std::defaultfloat << (isRegression ? "  regressed" : "") << std::endl;
+            }
+
+            return regressions;
+        }
+
+        // the names file ships with the client, the benchmark is usually started from the solution or its own directory
+        std::filesystem::path FindNames()
+        {
+            for (const char* candidate : { "Client/Assets/names.txt", "../Client/Assets/names.txt" })
+            {
+                std::error_code error;
+                if (std::filesystem::is_regular_file(candidate, error)) return candidate;
+            }
+
+            return std::filesystem::path();
+        }
+
+        bool ParseArguments(int argc, char** argv, Options& options)
+        {
+            for (int i = 1; i < argc; i++)
+            {
+                const std::string argument = argv[i];
+
+                // every option but -save takes a value
+                const bool hasValue = i + 1 < argc;
+                const char* value = hasValue ? argv[i + 1] : "";
+
+                if (argument == "-save")
+                {
+                    options.mIsSaving = true;
+                    continue;
+                }
+
+                if (!hasValue)
+                {
+                    gep::cerr << "Missing a value for " << argument << std::endl;
+                    return false;
+                }
+
+                if      (argument == "-files")     options.mCorpus.mFileCount = std::strtoull(value, nullptr, 10);
+                else if (argument == "-size")      options.mCorpus.mFileSize = std::strtoull(value, nullptr, 10);
+                else if (argument == "-reflected") options.mCorpus.mReflectedFiles = std::strtod(value, nullptr);
+                else if (argument == "-density")   options.mCorpus.mFieldDensity = std::strtod(value, nullptr);
+                else if (argument == "-seed")      options.mCorpus.mSeed = std::strtoull(value, nullptr, 10);
+                else if (argument == "-j")         options.mThreadCount = std::strtoull(value, nullptr, 10);
+                else if (argument == "-repeat")    options.mRepeatCount = std::max<size_t>(1, std::strtoull(value, nullptr, 10));
+                else if (argument == "-names")     options.mNamesPath = value;
+                else if (argument == "-corpus")    options.mCorpusPath = value;
+                else if (argument == "-baseline")  options.mBaselinePath = value;
+                else if (argument == "-threshold") options.mThreshold = std::strtod(value, nullptr);
+                else if (argument == "-suite")     options.mSuites.push_back(value);
+                else
+                {
+                    gep::cerr << "Unknown option " << argument << std::endl;
+                    return false;
+                }
+
+                i++;
+            }
+
+            return true;
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    using namespace benchmark;
+
+    Options options;
+    if (!ParseArguments(argc, argv, options))
+    {
+        gep::cout << "usage: benchmark [-files N] [-size BYTES] [-reflected 0-1] [-density 0-1] [-seed N] [-j N] [-repeat N]" << std::endl
+                  << "                 [-suite pipeline|kernels|baseline|sizes|threads|serialize]... [-names PATH] [-corpus DIR]" << std::endl
+                  << "                 [-baseline PATH] [-save] [-threshold PERCENT]" << std::endl;
+        return 2;
+    }
+
+    if (options.mNamesPath.empty()) options.mNamesPath = FindNames();
+
+    std::vector<std::string> names;
+    if (!CorpusGenerator::LoadNames(options.mNamesPath, names))
+    {
+        gep::cerr << "Failed to read names from " << options.mNamesPath << ", pass one with -names" << std::endl;
+        return 2;
+    }
+
+    // the preprocessor writes into .meta of the current directory so the benchmark works inside of the corpus
+    const std::filesystem::path baselinePath = std::filesystem::absolute(options.mBaselinePath);
+
+    std::error_code error;
+    std::filesystem::create_directories(options.mCorpusPath, error);
+    std::filesystem::current_path(options.mCorpusPath, error);
+    if (error)
+    {
+        gep::cerr << "Failed to enter the corpus directory " << options.mCorpusPath << std::endl;
+        return 2;
+    }
+
+    CorpusGenerator generator(names, options.mCorpus);
+
+    gep::Timer generateTimer;
+    generateTimer.Start();
+    const std::vector<std::filesystem::path> files = generator.Write(".");
+    const uint64_t bytes = GetTotalSize(files);
+
+    gep::cout << "Generated " << files.size() << " headers, " << bytes / sMegabyte << " MB in " << generateTimer.AsString() << " seconds" << std::endl;
+
+    // stage totals come from the profiler, only the summary is kept so the overhead is two clock reads per stage
+    gep::Profiler::Enable(false);
+
+    std::vector<Metric> metrics;
+    if (IsSuiteEnabled(options, "pipeline"))  RunPipelineSuite(options, files, bytes, metrics);
+    if (IsSuiteEnabled(options, "kernels"))   RunKernelSuite(options, files, metrics);
+    if (IsSuiteEnabled(options, "baseline"))  RunBaselineSuite(options, files, metrics);
+    if (IsSuiteEnabled(options, "sizes"))     RunSizeSuite(options, names, metrics);
+    if (IsSuiteEnabled(options, "threads"))   RunThreadSuite(options, files, metrics);
+    if (IsSuiteEnabled(options, "serialize")) RunSerializeSuite(options, names, metrics);
+
+    metrics.push_back({ "peak_rss_mb", GetPeakMemory() / sMegabyte, "MB", false });
+
+    PrintMetrics(metrics);
+
+    if (options.mIsSaving)
+    {
+        if (!SaveBaseline(baselinePath, options, metrics))
+        {
+            gep::cerr << "Failed to write the baseline " << baselinePath << std::endl;
+            return 2;
+        }
+
+        gep::cout << "Baseline saved to " << baselinePath << std::endl;
+        return 0;
+    }
+
+    if (!std::filesystem::is_regular_file(baselinePath, error))
+    {
+        gep::cwar << "No baseline at " << baselinePath << ", save one with -save" << std::endl;
+        return 0;
+    }
+
+    const int regressions = CompareBaseline(baselinePath, options, metrics);
+    if (regressions > 0)
+    {
+        gep::cerr << regressions << " metrics lost more than " << options.mThreshold << "% against the baseline" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,255 @@
+/*****************************************************************//**
+ * \file   Batch.cpp
+ * \brief
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <string>
+
+#include <OutStream.hpp>
+
+// this
+#include "Batch.hpp"
+
+#include "ReflectionDatabase.hpp"
+
+namespace gep
+{
+    Batch::Batch(size_t threadCount)
+        : mPool(threadCount)
+        , mIsFollowing(false)
+    {
+        for (size_t i = 0; i < mPool.GetThreadCount(); i++)
+        {
+            mPreprocessors.push_back(std::make_unique<Preprocessor>());
+            mPreprocessors.back()->ShareCache(*mPreprocessors.front());
+        }
+    }
+
+    Preprocessor& Batch::GetPreprocessor()
+    {
+        return *mPreprocessors.front();
+    }
+
+    void Batch::SetConfig(const Preprocessor::Config& config)
+    {
+        for (const std::unique_ptr<Preprocessor>& preprocessor : mPreprocessors)
+        {
+            preprocessor->SetConfig(config);
+        }
+    }
+
+    std::vector<std::filesystem::path> Batch::FindFiles(const std::vector<std::filesystem::path>& roots, const std::vector<std::string>& extensions)
+    {
+        std::vector<std::filesystem::path> directories = roots;
+
+        // per worker so listing needs no locks
+        std::vector<std::vector<std::filesystem::path>> found(mPool.GetThreadCount());
+        std::vector<std::vector<std::filesystem::path>> subdirectories(mPool.GetThreadCount());
+
+        while (!directories.empty())
+        {
+            mPool.Run(directories.size(), [&](size_t worker, size_t index)
+                {
+                    std::error_code error;
+                    std::filesystem::directory_iterator it(directories[index], error);
+
+                    for (; !error && it != std::filesystem::directory_iterator(); it.increment(error))
+                    {
+                        const std::filesystem::directory_entry& entry = *it;
+
+                        std::error_code typeError;
+                        if (entry.is_directory(typeError))
+                        {
+                            // hidden folders such as .meta, .git and .vs never hold source, links could loop forever
+                            const std::string name = entry.path().filename().string();
+                            if (!name.empty() && name[0] != '.' && !entry.is_symlink(typeError))
+                            {
+                                subdirectories[worker].push_back(entry.path());
+                            }
+                        }
+                        else if (entry.is_regular_file(typeError) && HasExtension(entry.path(), extensions))
+                        {
+                            found[worker].push_back(entry.path().lexically_normal());
+                        }
+                    }
+                });
+
+            directories.clear();
+            for (std::vector<std::filesystem::path>& level : subdirectories)
+            {
+                directories.insert(directories.end(), level.begin(), level.end());
+                level.clear();
+            }
+        }
+
+        std::vector<std::filesystem::path> files;
+        for (const std::vector<std::filesystem::path>& list : found)
+        {
+            files.insert(files.end(), list.begin(), list.end());
+        }
+
+        // source paths may overlap, sorting also keeps the output the same from run to run
+        std::sort(files.begin(), files.end());
+        files.erase(std::unique(files.begin(), files.end()), files.end());
+
+        return files;
+    }
+
+    std::vector<std::filesystem::path> Batch::FindProjectFiles(const Preprocessor::Config& config)
+    {
+        // the directory of the config is always searched
+        std::vector<std::filesystem::path> roots = { "." };
+        roots.insert(roots.end(), config.mSourcePaths.begin(), config.mSourcePaths.end());
+
+        return FindFiles(roots, config.mFileExtensions);
+    }
+
+    size_t Batch::Run(const std::vector<std::filesystem::path>& files, std::ostream& out)
+    {
+        if (!mIsFollowing && mDatabasePath.empty()) return RunFiles(files, false, out);
+
+        // a header changed since the last run has to be parsed again, the database keeps the headers that did not change
+        if (mDatabasePath.empty()) mIncludeGraph.Clear();
+        else                       mIncludeGraph.ClearClaims();
+
+        // the same header given twice is still parsed once
+        std::vector<std::filesystem::path> level;
+        for (const std::filesystem::path& file : files)
+        {
+            if (mIncludeGraph.Claim(file)) level.push_back(file);
+        }
+
+        size_t failures = 0;
+        bool isDependency = false;
+        HeaderInfo info;
+
+        while (!level.empty())
+        {
+            failures += RunFiles(level, isDependency, out);
+
+            if (!mIsFollowing) break;
+
+            // claimed in the order of the level so the output is the same from run to run
+            std::vector<std::filesystem::path> next;
+            for (const std::filesystem::path& file : level)
+            {
+                if (!mIncludeGraph.Find(file, info)) continue;
+
+                for (const std::filesystem::path& include : info.mIncludes)
+                {
+                    if (mIncludeGraph.Claim(include)) next.push_back(include);
+                }
+            }
+
+            level = std::move(next);
+            isDependency = true;
+        }
+
+        if (!mDatabasePath.empty() && !ReflectionDatabase::Write(mDatabasePath, mIncludeGraph))
+        {
+            gep::cerr << "Failed to write the reflection database to " << mDatabasePath << std::endl;
+        }
+
+        return failures;
+    }
+
+    void Batch::SetFollowIncludes(bool isFollowing)
+    {
+        mIsFollowing = isFollowing;
+        UpdateIncludeGraph();
+    }
+
+    void Batch::SetDatabasePath(const std::filesystem::path& path)
+    {
+        mDatabasePath = path;
+        UpdateIncludeGraph();
+    }
+
+    const IncludeGraph& Batch::GetIncludeGraph() const
+    {
+        return mIncludeGraph;
+    }
+
+    inline size_t Batch::RunFiles(const std::vector<std::filesystem::path>& files, bool isDependency, std::ostream& out)
+    {
+        // each file's output is held until every file before it has been printed
+        std::vector<std::string> logs(files.size());
+        std::vector<char> isFinished(files.size(), false);
+        size_t nextToPrint = 0;
+        std::mutex printMutex;
+
+        std::atomic<size_t> failures = 0;
+
+        mPool.Run(files.size(), [&](size_t worker, size_t index)
+            {
+                {
+                    capture_output capture(logs[index]);
+                    if (mPreprocessors[worker]->PreprocessFile(files[index], isDependency) != 0) failures++;
+                }
+
+                std::lock_guard<std::mutex> lock(printMutex);
+                isFinished[index] = true;
+
+                while (nextToPrint < files.size() && isFinished[nextToPrint])
+                {
+                    out << logs[nextToPrint];
+                    std::string().swap(logs[nextToPrint]);
+                    nextToPrint++;
+                }
+                out.flush();
+            });
+
+        return failures;
+    }
+
+    void Batch::PrintStats()
+    {
+        // the cache is shared so the first worker has every count
+        GetPreprocessor().PrintCacheStats();
+
+        PrefilterStats stats;
+        for (const std::unique_ptr<Preprocessor>& preprocessor : mPreprocessors)
+        {
+            stats += preprocessor->GetPrefilterStats();
+        }
+
+        const double hitRate = stats.mFiles ? 100.0 * stats.mSkipped / stats.mFiles : 0.0;
+        gep::cout << "Prefilter: " << stats.mSkipped << " of " << stats.mFiles << " files had nothing to reflect ("
+                  << hitRate << "%), filtering took " << stats.mFilterSeconds << " seconds and saved about "
+                  << stats.GetSecondsSaved() << " seconds" << std::endl;
+
+        if (mIsFollowing)
+        {
+            gep::cout << "Includes: " << mIncludeGraph.GetHeaderCount() << " headers were each parsed once" << std::endl;
+        }
+    }
+
+    inline void Batch::UpdateIncludeGraph()
+    {
+        const bool isPublishing = mIsFollowing || !mDatabasePath.empty();
+
+        for (const std::unique_ptr<Preprocessor>& preprocessor : mPreprocessors)
+        {
+            preprocessor->SetIncludeGraph(isPublishing ? &mIncludeGraph : nullptr);
+        }
+    }
+
+    size_t Batch::GetThreadCount() const
+    {
+        return mPool.GetThreadCount();
+    }
+
+    bool Batch::HasExtension(const std::filesystem::path& path, const std::vector<std::string>& extensions)
+    {
+        const std::string extension = path.extension().string();
+        return std::find(extensions.begin(), extensions.end(), extension) != extensions.end();
+    }
+}
@@ -0,0 +1,85 @@
+/*****************************************************************//**
+ * \file   Batch.hpp
+ * \brief  preprocesses many files at once, every worker thread owns its
+ *         own Preprocessor so nothing but the cache is shared
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// preprocessor
+#include "Preprocessor.hpp"
+#include "ThreadPool.hpp"
+
+namespace gep
+{
+	class Batch
+	{
+	public:
+		// 0 uses every hardware thread
+		explicit Batch(size_t threadCount = 1);
+
+		// the preprocessor of the first worker, the others share its cache
+		Preprocessor& GetPreprocessor();
+
+		// every worker uses config, call before InitializeMetaHeader
+		void SetConfig(const Preprocessor::Config& config);
+
+		// walks every root a level of the tree at a time with each directory listed in parallel. returns sorted paths with one of the extensions
+		std::vector<std::filesystem::path> FindFiles(const std::vector<std::filesystem::path>& roots, const std::vector<std::string>& extensions);
+
+		// finds the files in the directory of the config and every source path
+		std::vector<std::filesystem::path> FindProjectFiles(const Preprocessor::Config& config);
+
+		// preprocesses every file, the output of each file is printed to out in the order given no matter which worker finished first. returns the number of files that failed.
+		// when following includes, the user headers they include are preprocessed after them a level at a time, each header once per run
+		size_t Run(const std::vector<std::filesystem::path>& files, std::ostream& out = std::cout);
+
+		// follows "" includes on every run from now on
+		void SetFollowIncludes(bool isFollowing);
+
+		// writes the reflection database of every header seen so far to path after every run, empty stops writing it
+		void SetDatabasePath(const std::filesystem::path& path);
+
+		// every header of the last run that followed includes or wrote a database
+		const IncludeGraph& GetIncludeGraph() const;
+
+		// prints the cache and prefilter summaries of every worker
+		void PrintStats();
+
+		size_t GetThreadCount() const;
+
+		// true if the extension of path is one of extensions
+		static bool HasExtension(const std::filesystem::path& path, const std::vector<std::string>& extensions);
+
+	private:
+		// runs one level of files on the pool with ordered output
+		inline size_t RunFiles(const std::vector<std::filesystem::path>& files, bool isDependency, std::ostream& out);
+
+		// workers only publish to the graph when something reads it
+		inline void UpdateIncludeGraph();
+
+	private:
+		ThreadPool mPool;
+
+		// one per worker
+		std::vector<std::unique_ptr<Preprocessor>> mPreprocessors;
+
+		// shared by every worker, cleared at the start of each run
+		IncludeGraph mIncludeGraph;
+
+		bool mIsFollowing;
+
+		// empty when no database is written
+		std::filesystem::path mDatabasePath;
+	};
+} // namespace gep
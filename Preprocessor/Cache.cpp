@@ -0,0 +1,411 @@
+/*****************************************************************//**
+ * \file   Cache.cpp
+ * \brief
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+// this
+#include "Cache.hpp"
+
+#include "Hash.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace gep
+{
+    namespace
+    {
+        // exclusive lock on a file for as long as the object lives, held while the index is rewritten
+        class FileLock
+        {
+        public:
+            explicit FileLock(const std::filesystem::path& path)
+            {
+#ifdef _WIN32
+                mHandle = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                      nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+                if (mHandle == INVALID_HANDLE_VALUE) return;
+
+                OVERLAPPED overlapped = {};
+                mIsLocked = LockFileEx(mHandle, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &overlapped);
+#else
+                mHandle = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+                if (mHandle < 0) return;
+
+                mIsLocked = flock(mHandle, LOCK_EX) == 0;
+#endif
+            }
+
+            ~FileLock()
+            {
+#ifdef _WIN32
+                if (mHandle == INVALID_HANDLE_VALUE) return;
+
+                OVERLAPPED overlapped = {};
+                if (mIsLocked) UnlockFileEx(mHandle, 0, MAXDWORD, MAXDWORD, &overlapped);
+                CloseHandle(mHandle);
+#else
+                if (mHandle < 0) return;
+
+                if (mIsLocked) flock(mHandle, LOCK_UN);
+                close(mHandle);
+#endif
+            }
+
+            FileLock(const FileLock&) = delete;
+            FileLock& operator=(const FileLock&) = delete;
+
+            bool IsLocked() const
+            {
+                return mIsLocked;
+            }
+
+        private:
+#ifdef _WIN32
+            HANDLE mHandle = INVALID_HANDLE_VALUE;
+#else
+            int mHandle = -1;
+#endif
+            bool mIsLocked = false;
+        };
+
+        constexpr char sIndexMagic[4] = { 'G', 'E', 'P', 'C' };
+    }
+
+    Cache::Cache()
+        : mSeed(0)
+        , mCapacity(sDefaultCapacity)
+        , mEntries(nullptr)
+        , mEntryCount(0)
+        , mByteCount(0)
+        , mWarmBytes(0)
+        , mIsOpen(false)
+    {
+    }
+
+    Cache::~Cache()
+    {
+        Flush();
+    }
+
+    void Cache::Open(const std::filesystem::path& directory, uint64_t seed, uint64_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        mDirectory = directory;
+        mIndexPath = directory / "index";
+        mSeed = seed;
+        mCapacity = capacity;
+        mPending.clear();
+        mWarm.clear();
+        mWarmBytes = 0;
+        mStats = CacheStats();
+
+        std::error_code error;
+        std::filesystem::create_directories(mDirectory, error);
+        mIsOpen = !error;
+
+        if (mIsOpen) MapIndex();
+    }
+
+    uint64_t Cache::GetKey(std::string_view fileName, std::string_view contents) const
+    {
+        return Hash64(fileName, Hash64(contents, mSeed));
+    }
+
+    bool Cache::Find(uint64_t key, std::string& output, std::string& diagnostics)
+    {
+        CacheEntry entry;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (!mIsOpen) return false;
+
+            const auto pending = mPending.find(key);
+            const CacheEntry* mapped = (pending == mPending.end()) ? FindMapped(key) : nullptr;
+
+            if (pending != mPending.end()) entry = pending->second;
+            else if (mapped)                std::memcpy(&entry, mapped, sizeof(entry));
+            else
+            {
+                mStats.mMisses++;
+                return false;
+            }
+
+            // blobs this process has seen before are served from memory
+            const auto warm = mWarm.find(key);
+            if (warm != mWarm.end())
+            {
+                output.assign(warm->second);
+                SplitBlob(output, diagnostics);
+
+                entry.mLastUsed = Now();
+                mPending[key] = entry;
+                mStats.mHits++;
+
+                return true;
+            }
+        }
+
+        // the blob is read without the lock, another process may have evicted it so it is verified before use
+        SourceFile blob;
+        bool isValid = blob.Open(GetBlobPath(key))
+                    && blob.View().size() == entry.mSize
+                    && Hash64(blob.View()) == entry.mHash;
+
+        if (isValid)
+        {
+            output.assign(blob.View());
+            isValid = SplitBlob(output, diagnostics);
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!isValid)
+        {
+            mPending.erase(key);
+            mStats.mMisses++;
+            return false;
+        }
+
+        entry.mLastUsed = Now();
+        mPending[key] = entry;
+        mStats.mHits++;
+
+        Remember(key, blob.View());
+
+        return true;
+    }
+
+    void Cache::Store(uint64_t key, std::string_view output, std::string_view diagnostics)
+    {
+        if (!IsOpen()) return;
+
+        const uint64_t diagnosticsSize = diagnostics.size();
+
+        std::string blob;
+        blob.reserve(output.size() + diagnostics.size() + sizeof(diagnosticsSize));
+        blob.append(output);
+        blob.append(diagnostics);
+        blob.append(reinterpret_cast<const char*>(&diagnosticsSize), sizeof(diagnosticsSize));
+
+        // identical keys always produce identical blobs, so racing writers are harmless
+        if (!WriteAtomic(GetBlobPath(key), blob)) return;
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mPending[key] = CacheEntry{ key, Hash64(blob), Now(), blob.size() };
+        mStats.mStores++;
+
+        Remember(key, blob);
+    }
+
+    void Cache::Flush()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mIsOpen || mPending.empty()) return;
+
+        FileLock fileLock(mDirectory / "index.lock");
+        if (!fileLock.IsLocked()) return;
+
+        // another process may have flushed since this one mapped the index
+        MapIndex();
+        std::vector<CacheEntry> entries(mEntryCount);
+        if (mEntryCount) std::memcpy(entries.data(), mEntries, mEntryCount * sizeof(CacheEntry));
+
+        // the mapping has to be gone before the file can be replaced on windows
+        mIndexFile.Close();
+        mEntries = nullptr;
+        mEntryCount = 0;
+
+        for (const auto& [key, entry] : mPending) entries.push_back(entry);
+
+        // keeps the most recently used copy of each key
+        std::sort(entries.begin(), entries.end(), [](const CacheEntry& a, const CacheEntry& b)
+            {
+                return (a.mKey != b.mKey) ? a.mKey < b.mKey : a.mLastUsed > b.mLastUsed;
+            });
+        entries.erase(std::unique(entries.begin(), entries.end(), [](const CacheEntry& a, const CacheEntry& b) { return a.mKey == b.mKey; }), entries.end());
+
+        uint64_t bytes = 0;
+        for (const CacheEntry& entry : entries) bytes += entry.mSize;
+
+        // evicts the least recently used blobs until the cache fits
+        if (bytes > mCapacity)
+        {
+            std::sort(entries.begin(), entries.end(), [](const CacheEntry& a, const CacheEntry& b) { return a.mLastUsed < b.mLastUsed; });
+
+            size_t evicted = 0;
+            while (evicted < entries.size() && bytes > mCapacity)
+            {
+                std::error_code error;
+                std::filesystem::remove(GetBlobPath(entries[evicted].mKey), error);
+
+                bytes -= entries[evicted].mSize;
+                evicted++;
+            }
+
+            entries.erase(entries.begin(), entries.begin() + evicted);
+            mStats.mEvictions += evicted;
+
+            std::sort(entries.begin(), entries.end(), [](const CacheEntry& a, const CacheEntry& b) { return a.mKey < b.mKey; });
+        }
+
+        IndexHeader header = {};
+        std::memcpy(header.mMagic, sIndexMagic, sizeof(sIndexMagic));
+        header.mVersion = sIndexVersion;
+        header.mCount = entries.size();
+
+        std::string index(sizeof(header) + entries.size() * sizeof(CacheEntry), '\0');
+        std::memcpy(index.data(), &header, sizeof(header));
+        if (!entries.empty()) std::memcpy(index.data() + sizeof(header), entries.data(), entries.size() * sizeof(CacheEntry));
+
+        if (WriteAtomic(mIndexPath, index)) mPending.clear();
+
+        MapIndex();
+    }
+
+    CacheStats Cache::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mStats;
+    }
+
+    size_t Cache::GetEntryCount() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mEntryCount;
+    }
+
+    uint64_t Cache::GetByteCount() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mByteCount;
+    }
+
+    bool Cache::IsOpen() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mIsOpen;
+    }
+
+    void Cache::MapIndex()
+    {
+        mEntries = nullptr;
+        mEntryCount = 0;
+        mByteCount = 0;
+
+        if (!mIndexFile.Open(mIndexPath)) return;
+
+        const std::string_view view = mIndexFile.View();
+
+        IndexHeader header = {};
+        if (view.size() >= sizeof(header)) std::memcpy(&header, view.data(), sizeof(header));
+
+        const bool isValid = view.size() >= sizeof(header)
+                          && std::memcmp(header.mMagic, sIndexMagic, sizeof(sIndexMagic)) == 0
+                          && header.mVersion == sIndexVersion
+                          && view.size() == sizeof(header) + header.mCount * sizeof(CacheEntry);
+
+        if (!isValid)
+        {
+            mIndexFile.Close();
+            return;
+        }
+
+        mEntries = reinterpret_cast<const CacheEntry*>(view.data() + sizeof(header));
+        mEntryCount = static_cast<size_t>(header.mCount);
+
+        for (size_t i = 0; i < mEntryCount; i++) mByteCount += mEntries[i].mSize;
+    }
+
+    const CacheEntry* Cache::FindMapped(uint64_t key) const
+    {
+        const CacheEntry* end = mEntries + mEntryCount;
+        const CacheEntry* found = std::lower_bound(mEntries, end, key, [](const CacheEntry& entry, uint64_t key) { return entry.mKey < key; });
+
+        return (found != end && found->mKey == key) ? found : nullptr;
+    }
+
+    std::filesystem::path Cache::GetBlobPath(uint64_t key) const
+    {
+        static constexpr char sHex[] = "0123456789abcdef";
+
+        char name[16];
+        for (int i = 0; i < 16; i++) name[i] = sHex[(key >> (60 - i * 4)) & 0xF];
+
+        return mDirectory / std::string_view(name, sizeof(name));
+    }
+
+    void Cache::Remember(uint64_t key, std::string_view blob)
+    {
+        if (mWarmBytes + blob.size() > sWarmCapacity) return;
+
+        if (mWarm.emplace(key, blob).second) mWarmBytes += blob.size();
+    }
+
+    bool Cache::SplitBlob(std::string& output, std::string& diagnostics)
+    {
+        uint64_t diagnosticsSize = 0;
+        if (output.size() < sizeof(diagnosticsSize)) return false;
+
+        std::memcpy(&diagnosticsSize, output.data() + output.size() - sizeof(diagnosticsSize), sizeof(diagnosticsSize));
+        if (diagnosticsSize > output.size() - sizeof(diagnosticsSize)) return false;
+
+        const size_t outputSize = output.size() - sizeof(diagnosticsSize) - static_cast<size_t>(diagnosticsSize);
+        diagnostics.assign(output, outputSize, static_cast<size_t>(diagnosticsSize));
+        output.resize(outputSize);
+
+        return true;
+    }
+
+    bool Cache::WriteAtomic(const std::filesystem::path& path, std::string_view data)
+    {
+        // unique per process and call so concurrent writers, in this process or another one, never share a temp file
+        static std::atomic<uint64_t> sCalls = 0;
+
+#ifdef _WIN32
+        const uint64_t processId = GetCurrentProcessId();
+#else
+        const uint64_t processId = static_cast<uint64_t>(getpid());
+#endif
+
+        std::filesystem::path tempPath = path;
+        tempPath += ".tmp" + std::to_string(processId) + "." + std::to_string(sCalls.fetch_add(1, std::memory_order_relaxed));
+
+        {
+            std::ofstream file(tempPath, std::ios::binary);
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!file.flush()) return false;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, path, error);
+        if (error)
+        {
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+
+        return true;
+    }
+
+    uint64_t Cache::Now()
+    {
+        return static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+    }
+}
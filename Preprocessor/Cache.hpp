@@ -0,0 +1,150 @@
+/*****************************************************************//**
+ * \file   Cache.hpp
+ * \brief  on disk cache from the content hash of a header to the meta
+ *         file generated for it, shared by every run that uses the same
+ *         .meta folder
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// preprocessor
+#include "SourceFile.hpp"
+
+namespace gep
+{
+	// one entry of the index file, the index is a header followed by entries sorted by key
+	struct CacheEntry
+	{
+		uint64_t mKey;      // hash of the input file
+		uint64_t mHash;     // hash of the blob, checked on every hit
+		uint64_t mLastUsed; // ticks of the system clock, the oldest entries are evicted first
+		uint64_t mSize;     // size of the blob in bytes
+	};
+
+	struct CacheStats
+	{
+		size_t mHits = 0;
+		size_t mMisses = 0;
+		size_t mStores = 0;
+		size_t mEvictions = 0;
+	};
+
+	class Cache
+	{
+	public:
+		Cache();
+
+		// writes any pending changes
+		~Cache();
+
+		Cache(const Cache&) = delete;
+		Cache& operator=(const Cache&) = delete;
+
+		// maps the index inside of directory, creating the directory if needed. seed is mixed into every key
+		void Open(const std::filesystem::path& directory, uint64_t seed, uint64_t capacity = sDefaultCapacity);
+
+		// the key of an input file, its name is part of the key because the meta include checked and the warnings printed use it
+		uint64_t GetKey(std::string_view fileName, std::string_view contents) const;
+
+		// copies the output and the diagnostics stored for key, returns false on a miss
+		bool Find(uint64_t key, std::string& output, std::string& diagnostics);
+
+		// stores the output generated for key with the warnings printed while generating it so a hit can print them again,
+		// the index is only updated on Flush
+		void Store(uint64_t key, std::string_view output, std::string_view diagnostics);
+
+		// merges pending changes into the index on disk and evicts the least recently used blobs over capacity
+		void Flush();
+
+		// hits and misses since Open
+		CacheStats GetStats() const;
+
+		// the number of entries and bytes in the index as of the last Open or Flush
+		size_t GetEntryCount() const;
+		uint64_t GetByteCount() const;
+
+		bool IsOpen() const;
+
+	private:
+		struct IndexHeader
+		{
+			char mMagic[4];
+			uint32_t mVersion;
+			uint64_t mCount;
+		};
+
+		// maps the index file, an index that is missing or from another version is treated as empty
+		inline void MapIndex();
+
+		// binary search of the mapped index
+		inline const CacheEntry* FindMapped(uint64_t key) const;
+
+		// the path of the blob for key
+		inline std::filesystem::path GetBlobPath(uint64_t key) const;
+
+		// keeps a blob in memory for later hits until the warm capacity is used up, the lock must be held
+		inline void Remember(uint64_t key, std::string_view blob);
+
+		// a blob is the output, then the diagnostics, then the size of the diagnostics. false if the blob is too small for its sizes
+		static inline bool SplitBlob(std::string& output, std::string& diagnostics);
+
+		// writes data next to path then renames it over path
+		static inline bool WriteAtomic(const std::filesystem::path& path, std::string_view data);
+
+		static inline uint64_t Now();
+
+	private:
+		// bytes of blobs kept before the least recently used ones are evicted
+		static constexpr uint64_t sDefaultCapacity = 64ull * 1024 * 1024;
+
+		// bytes of blobs kept in memory, a long running process serves repeated hits without touching the disk
+		static constexpr uint64_t sWarmCapacity = 32ull * 1024 * 1024;
+
+		// changes whenever the layout of the index or blobs changes
+		static constexpr uint32_t sIndexVersion = 2;
+
+		std::filesystem::path mDirectory;
+
+		std::filesystem::path mIndexPath;
+
+		uint64_t mSeed;
+
+		uint64_t mCapacity;
+
+		// read only snapshot of the index, other processes replace the file rather than write into it
+		SourceFile mIndexFile;
+
+		const CacheEntry* mEntries;
+
+		size_t mEntryCount;
+
+		uint64_t mByteCount;
+
+		// new entries and entries that were hit, keyed by key
+		std::unordered_map<uint64_t, CacheEntry> mPending;
+
+		// blobs this process already read or wrote, keyed by key
+		std::unordered_map<uint64_t, std::string> mWarm;
+
+		uint64_t mWarmBytes;
+
+		CacheStats mStats;
+
+		// guards everything above so workers can share one cache
+		mutable std::mutex mMutex;
+
+		bool mIsOpen;
+	};
+} // namespace gep
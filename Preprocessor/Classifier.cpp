@@ -0,0 +1,500 @@
+/*****************************************************************//**
+ * \file   Classifier.cpp
+ * \brief
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+// std
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+// simdjson
+#include <simdjson.h>
+
+// this
+#include "Classifier.hpp"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define GEP_CLASSIFIER_X86
+#include <immintrin.h>
+#endif
+
+// msvc allows any intrinsic anywhere, gcc and clang need the target per function
+#if defined(_MSC_VER) && !defined(__clang__)
+#define GEP_TARGET(isa)
+#else
+#define GEP_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace gep
+{
+    namespace
+    {
+        // index of the lowest set bit, mask must not be 0
+        inline unsigned LowestBit(uint64_t mask)
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index;
+            _BitScanForward64(&index, mask);
+            return index;
+#else
+            return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+        }
+
+        // characters that may be part of an identifier or a number
+        inline bool IsWordCharacter(char c)
+        {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        }
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// kernels, each one classifies a single 64 byte block
+
+        void ScalarKernel(const char* block, CharacterMasks& masks)
+        {
+            masks = CharacterMasks{};
+
+            for (unsigned i = 0; i < 64; i++)
+            {
+                const uint64_t bit = 1ull << i;
+
+                switch (block[i])
+                {
+                case '"':  masks.mQuote      |= bit; break;
+                case '\'': masks.mApostrophe |= bit; break;
+                case '\\': masks.mBackslash  |= bit; break;
+                case '/':  masks.mSlash      |= bit; break;
+                case '*':  masks.mStar       |= bit; break;
+                case '\n': masks.mNewline    |= bit; break;
+                case ';': case '{': case '}': case '(': case ')': case '=':
+                    masks.mStructural |= bit;
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+
+#ifdef GEP_CLASSIFIER_X86
+        GEP_TARGET("avx2")
+        inline uint64_t EqualAvx2(__m256i lo, __m256i hi, char c)
+        {
+            const __m256i needle = _mm256_set1_epi8(c);
+
+            const uint32_t low  = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)));
+            const uint32_t high = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)));
+
+            return uint64_t(low) | (uint64_t(high) << 32);
+        }
+
+        GEP_TARGET("avx2")
+        void Avx2Kernel(const char* block, CharacterMasks& masks)
+        {
+            const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+            const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+
+            masks.mQuote      = EqualAvx2(lo, hi, '"');
+            masks.mApostrophe = EqualAvx2(lo, hi, '\'');
+            masks.mBackslash  = EqualAvx2(lo, hi, '\\');
+            masks.mSlash      = EqualAvx2(lo, hi, '/');
+            masks.mStar       = EqualAvx2(lo, hi, '*');
+            masks.mNewline    = EqualAvx2(lo, hi, '\n');
+            masks.mStructural = EqualAvx2(lo, hi, ';') | EqualAvx2(lo, hi, '{') | EqualAvx2(lo, hi, '}')
+                              | EqualAvx2(lo, hi, '(') | EqualAvx2(lo, hi, ')') | EqualAvx2(lo, hi, '=');
+        }
+
+        GEP_TARGET("sse4.2")
+        inline uint64_t EqualSse(const __m128i (&chunks)[4], char c)
+        {
+            const __m128i needle = _mm_set1_epi8(c);
+
+            uint64_t result = 0;
+            for (unsigned i = 0; i < 4; i++)
+            {
+                result |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunks[i], needle)))) << (i * 16);
+            }
+
+            return result;
+        }
+
+        GEP_TARGET("sse4.2")
+        void Sse42Kernel(const char* block, CharacterMasks& masks)
+        {
+            const __m128i chunks[4] =
+            {
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(block)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 32)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 48)),
+            };
+
+            masks.mQuote      = EqualSse(chunks, '"');
+            masks.mApostrophe = EqualSse(chunks, '\'');
+            masks.mBackslash  = EqualSse(chunks, '\\');
+            masks.mSlash      = EqualSse(chunks, '/');
+            masks.mStar       = EqualSse(chunks, '*');
+            masks.mNewline    = EqualSse(chunks, '\n');
+
+            // pcmpestrm matches all of the structural characters at once, explicit lengths so '\0' is not special
+            const __m128i structural = _mm_setr_epi8(';', '{', '}', '(', ')', '=', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+            masks.mStructural = 0;
+            for (unsigned i = 0; i < 4; i++)
+            {
+                const __m128i match = _mm_cmpestrm(structural, 6, chunks[i], 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK);
+
+                masks.mStructural |= uint64_t(static_cast<uint16_t>(_mm_cvtsi128_si32(match))) << (i * 16);
+            }
+        }
+#endif
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// applies context to the raw character masks, walking only the interesting bits of each block
+        class Resolver
+        {
+        public:
+            Resolver(std::string_view source, SourceMasks& masks)
+                : mSource(source)
+                , mMasks(masks)
+                , mPosition(0)
+                , mRegionStart(0)
+                , mState(State::Code)
+                , mQuote('"')
+                , mPreviousEscaped(0)
+            {
+            }
+
+            // processes one block, blocks must be given in order
+            void Resolve(size_t blockIndex, const CharacterMasks& characters)
+            {
+                const size_t base = blockIndex * 64;
+
+                const uint64_t escaped = FindEscaped(characters.mBackslash);
+
+                const uint64_t quote      = characters.mQuote & ~escaped;
+                const uint64_t apostrophe = characters.mApostrophe & ~escaped;
+                const uint64_t newline    = characters.mNewline;
+
+                while (true)
+                {
+                    // only events at or after the current position are relevant
+                    uint64_t floor = ~0ull;
+                    if (mPosition > base) floor = (mPosition - base >= 64) ? 0 : (~0ull << (mPosition - base));
+
+                    uint64_t events = 0;
+                    switch (mState)
+                    {
+                    case State::Code:         events = quote | apostrophe | characters.mSlash;                        break;
+                    case State::String:       events = (mQuote == '"' ? quote : apostrophe) | (newline & ~escaped);   break;
+                    case State::LineComment:  events = newline & ~escaped;                                            break;
+                    case State::BlockComment: events = characters.mStar;                                              break;
+                    }
+
+                    events &= floor;
+                    if (!events) return;
+
+                    const size_t index = base + LowestBit(events);
+
+                    switch (mState)
+                    {
+                    case State::Code:         OnCode(index);         break;
+                    case State::String:       OnString(index);       break;
+                    case State::LineComment:  OnLineComment(index);  break;
+                    case State::BlockComment: OnBlockComment(index); break;
+                    }
+                }
+            }
+
+            // closes any region left open at the end of the source
+            void Finish()
+            {
+                const size_t length = mSource.length();
+
+                switch (mState)
+                {
+                case State::Code:                                                      break;
+                case State::String:       SetRange(mMasks.mString, length);       break;
+                case State::LineComment:  SetRange(mMasks.mLineComment, length);  break;
+                case State::BlockComment: SetRange(mMasks.mBlockComment, length); break;
+                }
+
+                mState = State::Code;
+            }
+
+        private:
+            enum class State { Code, String, LineComment, BlockComment };
+
+            void OnCode(size_t index)
+            {
+                const char c = mSource[index];
+                const char next = (index + 1 < mSource.length()) ? mSource[index + 1] : '\0';
+
+                if (c == '/')
+                {
+                    mPosition = index + 1;
+
+                    if      (next == '/') mState = State::LineComment;
+                    else if (next == '*') mState = State::BlockComment;
+                    else return;
+
+                    mRegionStart = index;
+                    mPosition = index + 2;
+                    return;
+                }
+
+                // digit seperators ie 1'000'000 are not literals
+                if (c == '\'' && IsDigitSeperator(index))
+                {
+                    mPosition = index + 1;
+                    return;
+                }
+
+                if (c == '"' && IsRawString(index))
+                {
+                    mRegionStart = index;
+                    mPosition = FindRawStringEnd(index);
+                    SetRange(mMasks.mString, mPosition);
+                    return;
+                }
+
+                mState = State::String;
+                mQuote = c;
+                mRegionStart = index;
+                mPosition = index + 1;
+            }
+
+            void OnString(size_t index)
+            {
+                mState = State::Code;
+
+                // an unterminated literal ends at the end of the line
+                if (mSource[index] == '\n')
+                {
+                    SetRange(mMasks.mString, index);
+                    mPosition = index;
+                    return;
+                }
+
+                SetRange(mMasks.mString, index + 1);
+                mPosition = index + 1;
+            }
+
+            void OnLineComment(size_t index)
+            {
+                // a \ followed by \r\n still splices the line
+                if (index >= 2 && mSource[index - 1] == '\r' && mSource[index - 2] == '\\')
+                {
+                    mPosition = index + 1;
+                    return;
+                }
+
+                mState = State::Code;
+                SetRange(mMasks.mLineComment, index);
+                mPosition = index;
+            }
+
+            void OnBlockComment(size_t index)
+            {
+                mPosition = index + 1;
+
+                // the * of the opening /* cannot also close the comment
+                if (index == mRegionStart + 1) return;
+
+                if (index + 1 < mSource.length() && mSource[index + 1] == '/')
+                {
+                    mState = State::Code;
+                    SetRange(mMasks.mBlockComment, index + 2);
+                    mPosition = index + 2;
+                }
+            }
+
+            // sets every bit from the start of the current region up to end
+            void SetRange(std::vector<uint64_t>& mask, size_t end)
+            {
+                for (size_t i = mRegionStart; i < end;)
+                {
+                    const size_t block = i / 64;
+                    const size_t offset = i % 64;
+                    const size_t count = std::min<size_t>(64 - offset, end - i);
+
+                    const uint64_t bits = (count == 64) ? ~0ull : (((1ull << count) - 1) << offset);
+                    mask[block] |= bits;
+
+                    i += count;
+                }
+            }
+
+            // characters preceded by an odd number of backslashes, the same carry trick simdjson uses
+            uint64_t FindEscaped(uint64_t backslash)
+            {
+                constexpr uint64_t evenBits = 0x5555555555555555ull;
+
+                backslash &= ~mPreviousEscaped;
+                const uint64_t followsEscape = (backslash << 1) | mPreviousEscaped;
+
+                const uint64_t oddSequenceStarts = backslash & ~evenBits & ~followsEscape;
+
+                const uint64_t sequencesStartingOnEvenBits = oddSequenceStarts + backslash;
+                mPreviousEscaped = (sequencesStartingOnEvenBits < oddSequenceStarts) ? 1 : 0;
+
+                const uint64_t invertMask = sequencesStartingOnEvenBits << 1;
+
+                return (evenBits ^ invertMask) & followsEscape;
+            }
+
+            bool IsDigitSeperator(size_t index) const
+            {
+                // walks back to the start of the number or identifier the ' is attached to
+                size_t start = index;
+                while (start > 0 && (IsWordCharacter(mSource[start - 1]) || mSource[start - 1] == '\'' || mSource[start - 1] == '.'))
+                {
+                    start--;
+                }
+
+                return start < index && mSource[start] >= '0' && mSource[start] <= '9';
+            }
+
+            bool IsRawString(size_t index) const
+            {
+                if (index == 0 || mSource[index - 1] != 'R') return false;
+
+                // the R must be a whole prefix ie R, u8R, uR, UR or LR and not the end of an identifier
+                size_t start = index - 1;
+                while (start > 0 && IsWordCharacter(mSource[start - 1])) start--;
+
+                const std::string_view prefix = mSource.substr(start, index - 1 - start);
+
+                return prefix.empty() || prefix == "u8" || prefix == "u" || prefix == "U" || prefix == "L";
+            }
+
+            size_t FindRawStringEnd(size_t index) const
+            {
+                // R"delimiter( ... )delimiter"
+                const size_t open = mSource.find('(', index);
+                if (open == std::string_view::npos) return mSource.length();
+
+                std::string terminator(")");
+                terminator.append(mSource.substr(index + 1, open - index - 1)).push_back('"');
+
+                const size_t close = mSource.find(terminator, open + 1);
+                if (close == std::string_view::npos) return mSource.length();
+
+                return close + terminator.length();
+            }
+
+        private:
+            std::string_view mSource;
+
+            SourceMasks& mMasks;
+
+            // nothing before this position is looked at again
+            size_t mPosition;
+
+            // where the current string or comment began
+            size_t mRegionStart;
+
+            State mState;
+
+            // the quote that opened the current literal
+            char mQuote;
+
+            // 1 if the first character of the next block is escaped
+            uint64_t mPreviousEscaped;
+        };
+    }
+
+    size_t SourceMasks::NextClear(const std::vector<uint64_t>& mask, size_t index, size_t length)
+    {
+        size_t block = index / 64;
+
+        // bits below index are treated as set so they are skipped
+        uint64_t clear = ~mask[block] & (~0ull << (index % 64));
+
+        while (!clear)
+        {
+            block++;
+            if (block >= mask.size()) return length;
+
+            clear = ~mask[block];
+        }
+
+        return std::min(length, block * 64 + LowestBit(clear));
+    }
+
+    Classifier::Classifier()
+        : mKernel(&ScalarKernel)
+        , mKernelName("scalar")
+    {
+#ifdef GEP_CLASSIFIER_X86
+        // simdjson already detects the cpu once per process, its kernel names map directly onto ours
+        const std::string implementation = simdjson::get_active_implementation()->name();
+
+        if (implementation == "icelake" || implementation == "haswell")
+        {
+            mKernel = &Avx2Kernel;
+            mKernelName = "avx2";
+        }
+        else if (implementation == "westmere")
+        {
+            mKernel = &Sse42Kernel;
+            mKernelName = "sse4.2";
+        }
+#endif
+    }
+
+    void Classifier::Classify(std::string_view source, SourceMasks& masks) const
+    {
+        const size_t blockCount = (source.length() + 63) / 64;
+
+        masks.mString.assign(blockCount, 0);
+        masks.mLineComment.assign(blockCount, 0);
+        masks.mBlockComment.assign(blockCount, 0);
+        masks.mStructural.assign(blockCount, 0);
+
+        Resolver resolver(source, masks);
+        CharacterMasks characters;
+
+        const size_t fullBlocks = source.length() / 64;
+        for (size_t i = 0; i < fullBlocks; i++)
+        {
+            mKernel(source.data() + i * 64, characters);
+
+            resolver.Resolve(i, characters);
+            masks.mStructural[i] = characters.mStructural;
+        }
+
+        // the last partial block is padded with spaces, which are never classified
+        if (fullBlocks != blockCount)
+        {
+            char padded[64];
+            std::memset(padded, ' ', sizeof(padded));
+            std::memcpy(padded, source.data() + fullBlocks * 64, source.length() - fullBlocks * 64);
+
+            mKernel(padded, characters);
+
+            resolver.Resolve(fullBlocks, characters);
+            masks.mStructural[fullBlocks] = characters.mStructural;
+        }
+
+        resolver.Finish();
+
+        // structural characters only count outside of literals and comments
+        for (size_t i = 0; i < blockCount; i++)
+        {
+            masks.mStructural[i] &= ~(masks.mString[i] | masks.mLineComment[i] | masks.mBlockComment[i]);
+        }
+    }
+
+    const char* Classifier::GetKernelName() const
+    {
+        return mKernelName;
+    }
+}
@@ -0,0 +1,71 @@
+/*****************************************************************//**
+ * \file   Classifier.hpp
+ * \brief  vectorized pre-pass that finds string literals, comments and
+ *         token boundaries 64 bytes at a time, modeled on simdjson's
+ *         stage 1
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace gep
+{
+	// one bit per source character, bit i of block b describes character b * 64 + i
+	struct SourceMasks
+	{
+		std::vector<uint64_t> mString;       // inside a string or character literal, quotes included
+		std::vector<uint64_t> mLineComment;  // inside a // comment, up to but not including the newline
+		std::vector<uint64_t> mBlockComment; // inside a /* */ comment, delimiters included
+		std::vector<uint64_t> mStructural;   // one of ;{}()= outside of any literal or comment
+
+		// checks the bit for a character in one of the masks
+		static bool Test(const std::vector<uint64_t>& mask, size_t index)
+		{
+			return (mask[index / 64] >> (index % 64)) & 1;
+		}
+
+		// the index of the first character at or after index whose bit is not set
+		static size_t NextClear(const std::vector<uint64_t>& mask, size_t index, size_t length);
+	};
+
+	// the per block character masks a kernel produces, before any context is applied
+	struct CharacterMasks
+	{
+		uint64_t mQuote;      // "
+		uint64_t mApostrophe; // '
+		uint64_t mBackslash;  //
+		uint64_t mSlash;      // /
+		uint64_t mStar;       // *
+		uint64_t mNewline;    // \n
+		uint64_t mStructural; // ;{}()=
+	};
+
+	class Classifier
+	{
+	public:
+		// picks the fastest kernel the current cpu supports
+		Classifier();
+
+		// fills masks for every character in source
+		void Classify(std::string_view source, SourceMasks& masks) const;
+
+		// the name of the kernel in use ie avx2, sse4.2, scalar
+		const char* GetKernelName() const;
+
+	public:
+		// classifies exactly 64 bytes
+		using Kernel = void(*)(const char* block, CharacterMasks& masks);
+
+	private:
+		Kernel mKernel;
+
+		const char* mKernelName;
+	};
+} // namespace gep
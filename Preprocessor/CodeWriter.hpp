@@ -0,0 +1,61 @@
+/*****************************************************************//**
+ * \file   CodeWriter.hpp
+ * \brief  append only buffer that generated code is written into front
+ *         to back, its memory is reused from file to file
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <string>
+#include <string_view>
+
+namespace gep
+{
+	class CodeWriter
+	{
+	public:
+		CodeWriter() = default;
+
+		// makes sure at least bytes can be written without reallocating
+		void Reserve(size_t bytes)
+		{
+			mBuffer.reserve(bytes);
+		}
+
+		// appends every piece in order
+		template <typename... Pieces>
+		CodeWriter& Append(const Pieces&... pieces)
+		{
+			(mBuffer.append(std::string_view(pieces)), ...);
+			return *this;
+		}
+
+		// appends every piece followed by a newline
+		template <typename... Pieces>
+		CodeWriter& Line(const Pieces&... pieces)
+		{
+			Append(pieces...);
+			mBuffer.push_back('\n');
+			return *this;
+		}
+
+		// everything written so far
+		std::string_view View() const
+		{
+			return mBuffer;
+		}
+
+		// empties the buffer but keeps its memory for the next file
+		void Clear()
+		{
+			mBuffer.clear();
+		}
+
+	private:
+		std::string mBuffer;
+	};
+} // namespace gep
@@ -0,0 +1,384 @@
+/*****************************************************************//**
+ * \file   Daemon.cpp
+ * \brief
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+// std
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include <OutStream.hpp>
+
+// this
+#include "Daemon.hpp"
+
+#include "Batch.hpp"
+#include "Timer.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <afunix.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "Ws2_32.lib")
+#endif
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace gep
+{
+    namespace
+    {
+#ifdef _WIN32
+        using socket_t = SOCKET;
+        const socket_t sInvalidSocket = INVALID_SOCKET;
+#else
+        using socket_t = int;
+        const socket_t sInvalidSocket = -1;
+#endif
+
+        // writing to a client that hung up raises SIGPIPE, which would end the daemon, instead of failing the send.
+        // linux turns it off per send, mac per socket in LocalSocket::IgnoreBrokenPipe
+#ifdef MSG_NOSIGNAL
+        constexpr int sSendFlags = MSG_NOSIGNAL;
+#else
+        constexpr int sSendFlags = 0;
+#endif
+
+        // winsock has to be started once per process before any socket is made
+        bool StartSockets()
+        {
+#ifdef _WIN32
+            static const bool isStarted = []()
+                {
+                    WSADATA data;
+                    return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+                }();
+
+            return isStarted;
+#else
+            return true;
+#endif
+        }
+
+        // the command word that starts every request
+        const char* GetCommandName(Daemon::Command command)
+        {
+            switch (command)
+            {
+            case Daemon::Command::Project: return "project";
+            case Daemon::Command::Stop:    return "stop";
+            default:                       return "preprocess";
+            }
+        }
+
+        // a unix domain socket that messages are sent over as length prefixed frames
+        class LocalSocket
+        {
+        public:
+            LocalSocket() = default;
+
+            explicit LocalSocket(socket_t handle) : mHandle(handle) {}
+
+            LocalSocket(LocalSocket&& other) noexcept : mHandle(other.mHandle)
+            {
+                other.mHandle = sInvalidSocket;
+            }
+
+            LocalSocket(const LocalSocket&) = delete;
+            LocalSocket& operator=(const LocalSocket&) = delete;
+
+            ~LocalSocket()
+            {
+                Close();
+            }
+
+            bool Connect(const std::filesystem::path& path)
+            {
+                sockaddr_un address;
+                if (!MakeAddress(path, address) || !Create()) return false;
+
+                if (connect(mHandle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+                {
+                    Close();
+                    return false;
+                }
+
+                return true;
+            }
+
+            bool Listen(const std::filesystem::path& path)
+            {
+                sockaddr_un address;
+                if (!MakeAddress(path, address) || !Create()) return false;
+
+                if (bind(mHandle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(mHandle, 16) != 0)
+                {
+                    Close();
+                    return false;
+                }
+
+                return true;
+            }
+
+            LocalSocket Accept()
+            {
+                LocalSocket client(accept(mHandle, nullptr, nullptr));
+                client.IgnoreBrokenPipe();
+
+                return client;
+            }
+
+            // a 4 byte little endian length followed by the bytes of the frame
+            bool Send(std::string_view frame)
+            {
+                const uint32_t length = static_cast<uint32_t>(frame.size());
+                const unsigned char header[4] =
+                {
+                    static_cast<unsigned char>(length), static_cast<unsigned char>(length >> 8),
+                    static_cast<unsigned char>(length >> 16), static_cast<unsigned char>(length >> 24),
+                };
+
+                return SendAll(reinterpret_cast<const char*>(header), sizeof(header)) && SendAll(frame.data(), frame.size());
+            }
+
+            bool Receive(std::string& frame)
+            {
+                unsigned char header[4];
+                if (!ReceiveAll(reinterpret_cast<char*>(header), sizeof(header))) return false;
+
+                const uint32_t length = uint32_t(header[0]) | (uint32_t(header[1]) << 8) | (uint32_t(header[2]) << 16) | (uint32_t(header[3]) << 24);
+
+                frame.resize(length);
+                return ReceiveAll(frame.data(), length);
+            }
+
+            bool IsValid() const
+            {
+                return mHandle != sInvalidSocket;
+            }
+
+            void Close()
+            {
+                if (mHandle == sInvalidSocket) return;
+
+#ifdef _WIN32
+                closesocket(mHandle);
+#else
+                close(mHandle);
+#endif
+                mHandle = sInvalidSocket;
+            }
+
+        private:
+            bool Create()
+            {
+                mHandle = socket(AF_UNIX, SOCK_STREAM, 0);
+                IgnoreBrokenPipe();
+
+                return IsValid();
+            }
+
+            void IgnoreBrokenPipe()
+            {
+#ifdef SO_NOSIGPIPE
+                const int isSet = 1;
+                if (IsValid()) setsockopt(mHandle, SOL_SOCKET, SO_NOSIGPIPE, &isSet, sizeof(isSet));
+#endif
+            }
+
+            static bool MakeAddress(const std::filesystem::path& path, sockaddr_un& address)
+            {
+                const std::string text = path.string();
+
+                std::memset(&address, 0, sizeof(address));
+                address.sun_family = AF_UNIX;
+
+                // the path has to fit with its terminator
+                if (text.size() >= sizeof(address.sun_path)) return false;
+
+                std::memcpy(address.sun_path, text.c_str(), text.size());
+                return true;
+            }
+
+            bool SendAll(const char* data, size_t size)
+            {
+                while (size)
+                {
+                    const int sent = static_cast<int>(send(mHandle, data, static_cast<int>(size), sSendFlags));
+#ifndef _WIN32
+                    if (sent < 0 && errno == EINTR) continue;
+#endif
+                    // EPIPE or a reset means the other side is gone
+                    if (sent <= 0) return false;
+
+                    data += sent;
+                    size -= sent;
+                }
+
+                return true;
+            }
+
+            bool ReceiveAll(char* data, size_t size)
+            {
+                while (size)
+                {
+                    const int received = static_cast<int>(recv(mHandle, data, static_cast<int>(size), 0));
+                    if (received <= 0) return false;
+
+                    data += received;
+                    size -= received;
+                }
+
+                return true;
+            }
+
+        private:
+            socket_t mHandle = sInvalidSocket;
+        };
+    }
+
+    Daemon::Daemon(Batch& batch)
+        : mBatch(batch)
+    {
+    }
+
+    bool Daemon::Run(const std::filesystem::path& socketPath)
+    {
+        if (!StartSockets())
+        {
+            gep::cerr << "Failed to start sockets" << std::endl;
+            return false;
+        }
+
+        // a socket left behind by a daemon that died is removed, a live one means this directory is already served
+        LocalSocket probe;
+        if (probe.Connect(socketPath))
+        {
+            gep::cerr << "A daemon is already running for this directory" << std::endl;
+            return false;
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(socketPath.parent_path(), error);
+        std::filesystem::remove(socketPath, error);
+
+        LocalSocket listener;
+        if (!listener.Listen(socketPath))
+        {
+            gep::cerr << "Failed to listen on " << socketPath << std::endl;
+            return false;
+        }
+
+        gep::cout << "Daemon listening on " << socketPath << std::endl;
+
+        bool isRunning = true;
+        while (isRunning)
+        {
+            LocalSocket client = listener.Accept();
+            if (!client.IsValid()) continue;
+
+            std::string request;
+            if (!client.Receive(request)) continue;
+
+            Timer timer;
+            timer.Start();
+
+            std::string output;
+            size_t failures = 0;
+            isRunning = Serve(request, output, failures);
+
+            // a client that hung up only loses its own reply
+            if (!client.Send(std::to_string(failures)) || !client.Send(output))
+            {
+                gep::cwar << "The client disconnected before the reply was sent" << std::endl;
+                continue;
+            }
+
+            gep::cout << "Request served in " << timer.AsString() << " seconds" << std::endl;
+        }
+
+        listener.Close();
+        std::filesystem::remove(socketPath, error);
+
+        return true;
+    }
+
+    bool Daemon::Forward(const std::filesystem::path& socketPath, Command command, const std::vector<std::filesystem::path>& files,
+                         std::string& output, size_t& failures)
+    {
+        if (!StartSockets()) return false;
+
+        LocalSocket daemon;
+        if (!daemon.Connect(socketPath)) return false;
+
+        // the command then one path per line, absolute so the daemon does not depend on where the client was started
+        std::string request = GetCommandName(command);
+        for (const std::filesystem::path& file : files)
+        {
+            request += '\n';
+            request += std::filesystem::absolute(file).string();
+        }
+
+        std::string failureCount;
+        if (!daemon.Send(request) || !daemon.Receive(failureCount) || !daemon.Receive(output)) return false;
+
+        failures = std::strtoull(failureCount.c_str(), nullptr, 10);
+
+        return true;
+    }
+
+    bool Daemon::Serve(std::string_view request, std::string& output, size_t& failures)
+    {
+        const size_t commandEnd = std::min(request.find('\n'), request.size());
+        const std::string_view command = request.substr(0, commandEnd);
+
+        if (command == GetCommandName(Command::Stop))
+        {
+            output = "Daemon stopped\n";
+            return false;
+        }
+
+        std::vector<std::filesystem::path> files;
+        if (command == GetCommandName(Command::Project))
+        {
+            Preprocessor& preprocessor = mBatch.GetPreprocessor();
+            if (!preprocessor.IsProjectMode())
+            {
+                output = "The daemon was not started with -project\n";
+                failures = 1;
+                return true;
+            }
+
+            files = mBatch.FindProjectFiles(preprocessor.GetConfig());
+        }
+        else
+        {
+            for (size_t start = commandEnd + 1; start < request.size();)
+            {
+                const size_t end = std::min(request.find('\n', start), request.size());
+                if (end > start) files.emplace_back(request.substr(start, end - start));
+
+                start = end + 1;
+            }
+        }
+
+        std::ostringstream stream;
+        failures = mBatch.Run(files, stream);
+        output = stream.str();
+
+        // other processes see new cache entries without waiting for the daemon to exit
+        mBatch.GetPreprocessor().FlushCache();
+
+        return true;
+    }
+}
@@ -0,0 +1,53 @@
+/*****************************************************************//**
+ * \file   Daemon.hpp
+ * \brief  keeps a batch of preprocessors alive behind a local socket so
+ *         startup, config parsing and cache loading are paid only once,
+ *         clients in the same directory forward their requests to it
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gep
+{
+	class Batch;
+
+	// relative to the directory the daemon and its clients run in
+	inline constexpr const char* sDaemonSocketName = ".meta/daemon.sock";
+
+	class Daemon
+	{
+	public:
+		// what a client can ask for
+		enum class Command
+		{
+			Preprocess, // the paths that follow
+			Project,    // every file of the daemon's project config
+			Stop,
+		};
+
+		explicit Daemon(Batch& batch);
+
+		// serves clients one at a time until one of them sends Stop, returns false if the socket could not be created
+		bool Run(const std::filesystem::path& socketPath);
+
+		// sends a request to a running daemon and receives the output of the files, returns false when no daemon is listening
+		static bool Forward(const std::filesystem::path& socketPath, Command command, const std::vector<std::filesystem::path>& files,
+		                    std::string& output, size_t& failures);
+
+	private:
+		// handles one request, returns false once a client asked the daemon to stop
+		inline bool Serve(std::string_view request, std::string& output, size_t& failures);
+
+	private:
+		Batch& mBatch;
+	};
+} // namespace gep
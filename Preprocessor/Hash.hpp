@@ -0,0 +1,136 @@
+/*****************************************************************//**
+ * \file   Hash.hpp
+ * \brief  fast non cryptographic 64 bit hash for whole buffers, follows
+ *         the xxh64 algorithm so results match other xxh64 tools
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace gep
+{
+	// backend implementation
+	namespace detail
+	{
+		inline constexpr uint64_t sHashPrime1 = 11400714785074694791ull;
+		inline constexpr uint64_t sHashPrime2 = 14029467366897019727ull;
+		inline constexpr uint64_t sHashPrime3 = 1609587929392839161ull;
+		inline constexpr uint64_t sHashPrime4 = 9650029242287828579ull;
+		inline constexpr uint64_t sHashPrime5 = 2870177450012600261ull;
+
+		inline uint64_t RotateLeft(uint64_t value, int bits)
+		{
+			return (value << bits) | (value >> (64 - bits));
+		}
+
+		// unaligned little endian loads
+		inline uint64_t Read64(const unsigned char* data)
+		{
+			uint64_t value;
+			std::memcpy(&value, data, sizeof(value));
+			return value;
+		}
+
+		inline uint32_t Read32(const unsigned char* data)
+		{
+			uint32_t value;
+			std::memcpy(&value, data, sizeof(value));
+			return value;
+		}
+
+		inline uint64_t HashRound(uint64_t accumulator, uint64_t input)
+		{
+			accumulator += input * sHashPrime2;
+			accumulator = RotateLeft(accumulator, 31);
+			return accumulator * sHashPrime1;
+		}
+
+		inline uint64_t HashMerge(uint64_t accumulator, uint64_t lane)
+		{
+			accumulator ^= HashRound(0, lane);
+			return accumulator * sHashPrime1 + sHashPrime4;
+		}
+	} // namespace detail
+
+	// hashes size bytes starting at data, 32 bytes are consumed per step in four independent lanes
+	inline uint64_t Hash64(const void* data, size_t size, uint64_t seed = 0)
+	{
+		using namespace detail;
+
+		const unsigned char* position = static_cast<const unsigned char*>(data);
+		const unsigned char* end = position + size;
+
+		uint64_t hash;
+
+		if (size >= 32)
+		{
+			uint64_t lane1 = seed + sHashPrime1 + sHashPrime2;
+			uint64_t lane2 = seed + sHashPrime2;
+			uint64_t lane3 = seed;
+			uint64_t lane4 = seed - sHashPrime1;
+
+			const unsigned char* const lastStripe = end - 32;
+			do
+			{
+				lane1 = HashRound(lane1, Read64(position));
+				lane2 = HashRound(lane2, Read64(position + 8));
+				lane3 = HashRound(lane3, Read64(position + 16));
+				lane4 = HashRound(lane4, Read64(position + 24));
+				position += 32;
+			} while (position <= lastStripe);
+
+			hash = RotateLeft(lane1, 1) + RotateLeft(lane2, 7) + RotateLeft(lane3, 12) + RotateLeft(lane4, 18);
+			hash = HashMerge(hash, lane1);
+			hash = HashMerge(hash, lane2);
+			hash = HashMerge(hash, lane3);
+			hash = HashMerge(hash, lane4);
+		}
+		else
+		{
+			hash = seed + sHashPrime5;
+		}
+
+		hash += static_cast<uint64_t>(size);
+
+		// the tail is mixed 8, then 4, then 1 byte at a time
+		for (; position + 8 <= end; position += 8)
+		{
+			hash ^= HashRound(0, Read64(position));
+			hash = RotateLeft(hash, 27) * sHashPrime1 + sHashPrime4;
+		}
+
+		if (position + 4 <= end)
+		{
+			hash ^= static_cast<uint64_t>(Read32(position)) * sHashPrime1;
+			hash = RotateLeft(hash, 23) * sHashPrime2 + sHashPrime3;
+			position += 4;
+		}
+
+		for (; position < end; position++)
+		{
+			hash ^= (*position) * sHashPrime5;
+			hash = RotateLeft(hash, 11) * sHashPrime1;
+		}
+
+		// final avalanche
+		hash ^= hash >> 33;
+		hash *= sHashPrime2;
+		hash ^= hash >> 29;
+		hash *= sHashPrime3;
+		hash ^= hash >> 32;
+
+		return hash;
+	}
+
+	inline uint64_t Hash64(std::string_view text, uint64_t seed = 0)
+	{
+		return Hash64(text.data(), text.size(), seed);
+	}
+} // namespace gep
@@ -0,0 +1,86 @@
+/*****************************************************************//**
+ * \file   IncludeGraph.cpp
+ * \brief
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+// std
+#include <algorithm>
+
+// this
+#include "IncludeGraph.hpp"
+
+namespace gep
+{
+    std::filesystem::path IncludeGraph::GetKey(const std::filesystem::path& path)
+    {
+        // lexical only, resolving links would touch the disk for every include of every header
+        std::error_code error;
+        const std::filesystem::path absolute = std::filesystem::absolute(path, error);
+
+        return (error ? path : absolute).lexically_normal();
+    }
+
+    bool IncludeGraph::Claim(const std::filesystem::path& path)
+    {
+        const std::string key = GetKey(path).string();
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mClaimed.insert(key).second;
+    }
+
+    void IncludeGraph::Publish(const std::filesystem::path& path, HeaderInfo info)
+    {
+        const std::string key = GetKey(path).string();
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mClaimed.insert(key);
+        mHeaders[key] = std::move(info);
+    }
+
+    bool IncludeGraph::Find(const std::filesystem::path& path, HeaderInfo& info) const
+    {
+        const std::string key = GetKey(path).string();
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        const auto found = mHeaders.find(key);
+        if (found == mHeaders.end()) return false;
+
+        info = found->second;
+        return true;
+    }
+
+    std::vector<std::filesystem::path> IncludeGraph::GetHeaders() const
+    {
+        std::vector<std::filesystem::path> headers;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            headers.reserve(mHeaders.size());
+            for (const auto& [key, info] : mHeaders) headers.emplace_back(key);
+        }
+
+        std::sort(headers.begin(), headers.end());
+        return headers;
+    }
+
+    size_t IncludeGraph::GetHeaderCount() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mHeaders.size();
+    }
+
+    void IncludeGraph::Clear()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mHeaders.clear();
+        mClaimed.clear();
+    }
+
+    void IncludeGraph::ClearClaims()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mClaimed.clear();
+    }
+}
@@ -0,0 +1,88 @@
+/*****************************************************************//**
+ * \file   IncludeGraph.hpp
+ * \brief  every header seen during a run with the user headers it
+ *         includes and the fields it reflects, shared by every worker
+ *         so each header is parsed once no matter how often it is
+ *         included
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace gep
+{
+	// a reflected field with its strings resolved so it outlives the preprocessor that found it
+	struct ReflectedField
+	{
+		std::string mClassPath;
+		std::string mType;
+		std::string mName;
+		uint32_t mFlags; // FieldFlag bits, a field marked by both keywords has both
+
+		// how many of the leading scopes of the class path are namespaces
+		uint32_t mNamespaceDepth;
+
+		// where the declaration sits in the header, lines start at 1
+		uint32_t mLine;
+		uint32_t mOffset;
+		uint32_t mLength;
+	};
+
+	// what one header contributed to the run
+	struct HeaderInfo
+	{
+		// user includes that were found on disk, in the order they appear
+		std::vector<std::filesystem::path> mIncludes;
+
+		// every reflected field of every class in the header
+		std::vector<ReflectedField> mFields;
+	};
+
+	class IncludeGraph
+	{
+	public:
+		// the form every path is stored in, two spellings of the same file share a key
+		static std::filesystem::path GetKey(const std::filesystem::path& path);
+
+		// true for the first caller only, whoever claims a header is the one that parses it
+		bool Claim(const std::filesystem::path& path);
+
+		// stores what a claimed header contributed, replacing anything stored before
+		void Publish(const std::filesystem::path& path, HeaderInfo info);
+
+		// copies what path contributed into info, false if it was never published
+		bool Find(const std::filesystem::path& path, HeaderInfo& info) const;
+
+		// every published header in sorted order
+		std::vector<std::filesystem::path> GetHeaders() const;
+
+		size_t GetHeaderCount() const;
+
+		// forgets every header, the next run parses everything again
+		void Clear();
+
+		// forgets who claimed what but keeps what was published, a header that did not change keeps its fields
+		void ClearClaims();
+
+	private:
+		// keyed by GetKey
+		std::unordered_map<std::string, HeaderInfo> mHeaders;
+
+		// a claimed header has no info until it is published
+		std::unordered_set<std::string> mClaimed;
+
+		// guards everything above so workers can share one graph
+		mutable std::mutex mMutex;
+	};
+} // namespace gep
@@ -0,0 +1,129 @@
+/*****************************************************************//**
+ * \file   Interner.cpp
+ * \brief
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+// std
+#include <cstring>
+
+// this
+#include "Interner.hpp"
+
+namespace gep
+{
+    Interner::Interner()
+        : mCurrentPage(nullptr)
+        , mPageUsed(sPageSize)
+        , mSlots(1024, 0)
+        , mPageBytes(0)
+    {
+    }
+
+    StringId Interner::Intern(std::string_view text)
+    {
+        const uint64_t hash = Hash(text);
+        const uint32_t shortHash = static_cast<uint32_t>(hash);
+
+        // linear probing, the table size is always a power of 2
+        const size_t mask = mSlots.size() - 1;
+        size_t slot = static_cast<size_t>(hash) & mask;
+
+        while (mSlots[slot] != 0)
+        {
+            const StringId id = mSlots[slot] - 1;
+            if (mHashes[id] == shortHash && mStrings[id] == text) return id;
+
+            slot = (slot + 1) & mask;
+        }
+
+        const StringId id = static_cast<StringId>(mStrings.size());
+
+        mStrings.push_back(Store(text));
+        mHashes.push_back(shortHash);
+        mSlots[slot] = id + 1;
+
+        // keeps the table at most half full so probes stay short
+        if (mStrings.size() * 2 > mSlots.size()) Grow();
+
+        return id;
+    }
+
+    std::string_view Interner::Lookup(StringId id) const
+    {
+        return mStrings[id];
+    }
+
+    size_t Interner::GetCount() const
+    {
+        return mStrings.size();
+    }
+
+    size_t Interner::GetMemoryUsage() const
+    {
+        return mPageBytes
+            + mStrings.capacity() * sizeof(std::string_view)
+            + mSlots.capacity() * sizeof(StringId)
+            + mHashes.capacity() * sizeof(uint32_t)
+            + mPages.capacity() * sizeof(std::unique_ptr<char[]>);
+    }
+
+    std::string_view Interner::Store(std::string_view text)
+    {
+        if (text.empty()) return std::string_view();
+
+        // strings larger than a page get a page of their own, the current page stays open
+        if (text.length() > sPageSize)
+        {
+            std::unique_ptr<char[]>& page = mPages.emplace_back(new char[text.length()]);
+            std::memcpy(page.get(), text.data(), text.length());
+
+            mPageBytes += text.length();
+            return std::string_view(page.get(), text.length());
+        }
+
+        if (mPageUsed + text.length() > sPageSize)
+        {
+            mCurrentPage = mPages.emplace_back(new char[sPageSize]).get();
+            mPageUsed = 0;
+            mPageBytes += sPageSize;
+        }
+
+        char* destination = mCurrentPage + mPageUsed;
+        std::memcpy(destination, text.data(), text.length());
+        mPageUsed += text.length();
+
+        return std::string_view(destination, text.length());
+    }
+
+    void Interner::Grow()
+    {
+        std::vector<StringId> slots(mSlots.size() * 2, 0);
+        const size_t mask = slots.size() - 1;
+
+        for (StringId id = 0; id < mStrings.size(); id++)
+        {
+            size_t slot = mHashes[id] & mask;
+            while (slots[slot] != 0) slot = (slot + 1) & mask;
+
+            slots[slot] = id + 1;
+        }
+
+        mSlots.swap(slots);
+    }
+
+    uint64_t Interner::Hash(std::string_view text)
+    {
+        // fnv-1a, identifiers are short so a simple byte hash is plenty
+        uint64_t hash = 14695981039346656037ull;
+        for (const char c : text)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+}
@@ -0,0 +1,72 @@
+/*****************************************************************//**
+ * \file   Interner.hpp
+ * \brief  maps each distinct string to a small integer id for the
+ *         lifetime of a run so strings can be compared as integers
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace gep
+{
+	// an interned string, ids are handed out in order starting at 0
+	using StringId = uint32_t;
+
+	class Interner
+	{
+	public:
+		Interner();
+
+		// returns the id of text, copying it into the interner the first time it is seen
+		StringId Intern(std::string_view text);
+
+		// the text of an id, valid for the lifetime of the interner
+		std::string_view Lookup(StringId id) const;
+
+		// the number of distinct strings
+		size_t GetCount() const;
+
+		// bytes owned by the interner, including its tables
+		size_t GetMemoryUsage() const;
+
+	private:
+		// copies text into the current page, starting a new one when it does not fit
+		inline std::string_view Store(std::string_view text);
+
+		// doubles the slot table and reinserts every id
+		inline void Grow();
+
+		static inline uint64_t Hash(std::string_view text);
+
+	private:
+		// text is stored back to back in fixed size pages so views never move
+		static constexpr size_t sPageSize = 64 * 1024;
+
+		std::vector<std::unique_ptr<char[]>> mPages;
+
+		// the page small strings are copied into, big strings never go here
+		char* mCurrentPage;
+
+		size_t mPageUsed;
+
+		// indexed by id
+		std::vector<std::string_view> mStrings;
+
+		// open addressed table of id + 1, 0 marks an empty slot
+		std::vector<StringId> mSlots;
+
+		// the hash of each id so growing never rehashes text, indexed by id
+		std::vector<uint32_t> mHashes;
+
+		// bytes held by pages, big strings get a page of their own
+		size_t mPageBytes;
+	};
+} // namespace gep
@@ -0,0 +1,190 @@
+/*****************************************************************//**
+ * \file   Keywords.hpp
+ * \brief  the single table of keywords the preprocessor recognizes and
+ *         a compile time perfect hash over it
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace gep
+{
+	// what a token is, punctuation and keywords are recognized while lexing
+	enum class TokenKind : uint8_t
+	{
+		Identifier, // anything that is not recognized
+		Literal,    // string and character literals
+
+		OpenBrace, CloseBrace, OpenParen, CloseParen, Semicolon, Equals,
+
+		// keywords, each must have an entry in sKeywords
+		Class, Struct, Namespace,
+		Printable, Serializable,
+	};
+
+	// what a keyword does when it is found
+	enum class KeywordRole : uint8_t
+	{
+		Scope, // names the following {} scope ie class Foo {}
+		Meta,  // marks the following declaration for reflection
+	};
+
+	struct KeywordInfo
+	{
+		std::string_view mText;
+		TokenKind mKind;
+		KeywordRole mRole;
+	};
+
+	// every keyword that is recognized, new keywords are registered here and nowhere else
+	inline constexpr KeywordInfo sKeywords[] =
+	{
+		{ "class",        TokenKind::Class,        KeywordRole::Scope },
+		{ "struct",       TokenKind::Struct,       KeywordRole::Scope },
+		{ "namespace",    TokenKind::Namespace,    KeywordRole::Scope },
+		{ "printable",    TokenKind::Printable,    KeywordRole::Meta  },
+		{ "serializable", TokenKind::Serializable, KeywordRole::Meta  },
+	};
+
+	// backend implementation
+	namespace detail
+	{
+		inline constexpr size_t sKeywordCount = std::size(sKeywords);
+
+		// the table is kept at most half full so a seed is always found quickly
+		constexpr size_t KeywordTableBits()
+		{
+			size_t bits = 1;
+			while ((size_t(1) << bits) < sKeywordCount * 2) bits++;
+			return bits;
+		}
+
+		inline constexpr size_t sKeywordTableBits = KeywordTableBits();
+		inline constexpr size_t sKeywordTableSize = size_t(1) << sKeywordTableBits;
+
+		// the shortest and longest keyword, anything outside of the range is rejected before hashing
+		constexpr std::pair<size_t, size_t> KeywordLengthRange()
+		{
+			size_t shortest = sKeywords[0].mText.length();
+			size_t longest = shortest;
+			for (const KeywordInfo& keyword : sKeywords)
+			{
+				if (keyword.mText.length() < shortest) shortest = keyword.mText.length();
+				if (keyword.mText.length() > longest) longest = keyword.mText.length();
+			}
+			return { shortest, longest };
+		}
+
+		inline constexpr size_t sShortestKeyword = KeywordLengthRange().first;
+		inline constexpr size_t sLongestKeyword = KeywordLengthRange().second;
+
+		// mixes the first two characters, the last character and the length, text must not be empty
+		constexpr uint32_t KeywordHash(std::string_view text, uint32_t seed)
+		{
+			const uint32_t first  = static_cast<unsigned char>(text[0]);
+			const uint32_t second = static_cast<unsigned char>(text[text.length() > 1 ? 1 : 0]);
+			const uint32_t last   = static_cast<unsigned char>(text[text.length() - 1]);
+
+			const uint32_t key = (first << 24) ^ (second << 16) ^ (last << 8) ^ static_cast<uint32_t>(text.length());
+
+			// multiplicative hashing keeps the top bits
+			return (key * seed) >> (32 - sKeywordTableBits);
+		}
+
+		// searches for a multiplier that sends every keyword to its own slot, 0 if none exists
+		constexpr uint32_t FindKeywordSeed()
+		{
+			for (uint32_t seed = 1; seed < (1u << 20); seed += 2)
+			{
+				bool used[sKeywordTableSize] = {};
+				bool collision = false;
+
+				for (const KeywordInfo& keyword : sKeywords)
+				{
+					const uint32_t slot = KeywordHash(keyword.mText, seed);
+					if (used[slot])
+					{
+						collision = true;
+						break;
+					}
+					used[slot] = true;
+				}
+
+				if (!collision) return seed;
+			}
+
+			return 0;
+		}
+
+		inline constexpr uint32_t sKeywordSeed = FindKeywordSeed();
+		static_assert(sKeywordSeed != 0, "no perfect hash exists for sKeywords, change KeywordHash");
+
+		// slots that no keyword hashes to hold an empty string
+		constexpr std::array<KeywordInfo, sKeywordTableSize> BuildKeywordTable()
+		{
+			std::array<KeywordInfo, sKeywordTableSize> table = {};
+			for (KeywordInfo& slot : table) slot = { std::string_view(), TokenKind::Identifier, KeywordRole::Scope };
+
+			for (const KeywordInfo& keyword : sKeywords)
+			{
+				table[KeywordHash(keyword.mText, sKeywordSeed)] = keyword;
+			}
+
+			return table;
+		}
+
+		inline constexpr std::array<KeywordInfo, sKeywordTableSize> sKeywordTable = BuildKeywordTable();
+
+		// one bit per role for every token kind so role checks are a single load
+		constexpr std::array<uint8_t, 256> BuildRoleTable()
+		{
+			std::array<uint8_t, 256> roles = {};
+			for (const KeywordInfo& keyword : sKeywords)
+			{
+				roles[static_cast<size_t>(keyword.mKind)] |= uint8_t(1u << static_cast<unsigned>(keyword.mRole));
+			}
+
+			return roles;
+		}
+
+		inline constexpr std::array<uint8_t, 256> sKeywordRoles = BuildRoleTable();
+	} // namespace detail
+
+	// classifies an identifier with one hash and at most one compare, returns Identifier if it is not a keyword
+	constexpr TokenKind ClassifyKeyword(std::string_view text)
+	{
+		if (text.length() < detail::sShortestKeyword || text.length() > detail::sLongestKeyword) return TokenKind::Identifier;
+
+		const KeywordInfo& slot = detail::sKeywordTable[detail::KeywordHash(text, detail::sKeywordSeed)];
+
+		return (slot.mText == text) ? slot.mKind : TokenKind::Identifier;
+	}
+
+	// the registered text of a keyword, empty for anything that is not a keyword
+	constexpr std::string_view GetKeywordText(TokenKind kind)
+	{
+		for (const KeywordInfo& keyword : sKeywords)
+		{
+			if (keyword.mKind == kind) return keyword.mText;
+		}
+
+		return std::string_view();
+	}
+
+	// checks the role a keyword was registered with
+	constexpr bool HasKeywordRole(TokenKind kind, KeywordRole role)
+	{
+		return detail::sKeywordRoles[static_cast<size_t>(kind)] & (1u << static_cast<unsigned>(role));
+	}
+
+	static_assert(ClassifyKeyword("printable") == TokenKind::Printable);
+	static_assert(ClassifyKeyword("printables") == TokenKind::Identifier);
+} // namespace gep
@@ -0,0 +1,162 @@
+/*****************************************************************//**
+ * \file   Lexer.cpp
+ * \brief
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+// this
+#include "Lexer.hpp"
+
+namespace gep
+{
+    Lexer::Lexer(std::string_view source, const SourceMasks& masks)
+        : mSource(source)
+        , mMasks(masks)
+        , mPosition(0)
+    {
+    }
+
+    void Lexer::Tokenize(std::vector<Token>& tokens, std::vector<TokenKind>& kinds, std::vector<IncludeDirective>& includes)
+    {
+        constexpr size_t none = std::string_view::npos;
+
+        const size_t length = mSource.length();
+
+        // the start of the run of characters currently being collected
+        size_t tokenStart = none;
+
+        // ends the current run if there is one, runs are the only tokens that can be keywords
+        auto flush = [&]()
+            {
+                if (tokenStart != none)
+                {
+                    const Token& token = tokens.emplace_back(mSource.substr(tokenStart, mPosition - tokenStart));
+                    kinds.push_back(ClassifyKeyword(token));
+                    tokenStart = none;
+
+                    RecordInclude(tokens, includes);
+                }
+            };
+
+        while (mPosition < length)
+        {
+            const size_t block = mPosition / 64;
+            const uint64_t bit = 1ull << (mPosition % 64);
+
+            // comments are dropped entirely
+            if ((mMasks.mLineComment[block] | mMasks.mBlockComment[block]) & bit)
+            {
+                flush();
+
+                const std::vector<uint64_t>& comment = (mMasks.mLineComment[block] & bit) ? mMasks.mLineComment : mMasks.mBlockComment;
+                mPosition = SourceMasks::NextClear(comment, mPosition, length);
+                continue;
+            }
+
+            // literals are a single token, a prefix ie u8"" or R"()" stays attached
+            if (mMasks.mString[block] & bit)
+            {
+                size_t literalStart = mPosition;
+                if (tokenStart != none && IsLiteralPrefix(tokenStart)) literalStart = tokenStart;
+                else                                                    flush();
+
+                tokenStart = none;
+                mPosition = SourceMasks::NextClear(mMasks.mString, mPosition, length);
+
+                tokens.emplace_back(mSource.substr(literalStart, mPosition - literalStart));
+                kinds.push_back(TokenKind::Literal);
+
+                // a "" include is a literal
+                RecordInclude(tokens, includes);
+                continue;
+            }
+
+            // ;{}()= always form a token on their own
+            if (mMasks.mStructural[block] & bit)
+            {
+                flush();
+                tokens.emplace_back(mSource.substr(mPosition, 1));
+                kinds.push_back(GetPunctuationKind(mSource[mPosition]));
+                mPosition++;
+                continue;
+            }
+
+            if (IsSpace(mSource[mPosition]))
+            {
+                flush();
+                mPosition++;
+                continue;
+            }
+
+            // any other character extends the current run
+            if (tokenStart == none) tokenStart = mPosition;
+            mPosition++;
+        }
+
+        flush();
+    }
+
+    bool Lexer::IsSpace(char c)
+    {
+        switch (c)
+        {
+        case ' ': case '\t': case '\n': case '\r': case '\v': case '\f':
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    TokenKind Lexer::GetPunctuationKind(char c)
+    {
+        switch (c)
+        {
+        case '{': return TokenKind::OpenBrace;
+        case '}': return TokenKind::CloseBrace;
+        case '(': return TokenKind::OpenParen;
+        case ')': return TokenKind::CloseParen;
+        case ';': return TokenKind::Semicolon;
+        default:  return TokenKind::Equals;
+        }
+    }
+
+    bool Lexer::IsLiteralPrefix(size_t start) const
+    {
+        std::string_view run = mSource.substr(start, mPosition - start);
+
+        if (!run.empty() && run.back() == 'R') run.remove_suffix(1);
+
+        // the run is never empty here so an empty remainder was a lone R
+        return run.empty() || run == "u8" || run == "u" || run == "U" || run == "L";
+    }
+
+    void Lexer::RecordInclude(const std::vector<Token>& tokens, std::vector<IncludeDirective>& includes)
+    {
+        constexpr std::string_view directive = "#include";
+
+        const size_t count = tokens.size();
+        Token path = tokens.back();
+
+        if (path.length() > directive.length() && path.starts_with(directive))
+        {
+            // <> is not punctuation so #include<vector> is a single run
+            path.remove_prefix(directive.length());
+        }
+        else
+        {
+            const bool isDirective = (count >= 2 && tokens[count - 2] == directive)
+                                  || (count >= 3 && tokens[count - 2] == "include" && tokens[count - 3] == "#");
+            if (!isDirective) return;
+        }
+
+        if (path.length() < 2) return;
+
+        const bool isSystem = path.front() == '<' && path.back() == '>';
+        const bool isUser = path.front() == '"' && path.back() == '"';
+        if (!isSystem && !isUser) return;
+
+        includes.push_back({ path.substr(1, path.length() - 2), isSystem });
+    }
+}
@@ -0,0 +1,63 @@
+/*****************************************************************//**
+ * \file   Lexer.hpp
+ * \brief  single pass tokenizer, produces tokens as views into the
+ *         original source without modifying or copying it. comments
+ *         and literals are found through the classifier's bitmasks
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <string_view>
+#include <vector>
+
+// preprocessor
+#include "Classifier.hpp"
+#include "Keywords.hpp"
+
+namespace gep
+{
+	// a token is always a span inside of the buffer that was lexed
+	using Token = std::string_view;
+
+	// an #include found while lexing
+	struct IncludeDirective
+	{
+		std::string_view mPath; // without the <> or ""
+		bool mIsSystem;         // <> rather than "", never followed
+	};
+
+	class Lexer
+	{
+	public:
+		// the buffer must outlive every token produced from it, masks must come from classifying the same buffer
+		Lexer(std::string_view source, const SourceMasks& masks);
+
+		// lexes the entire source in one pass, appending each token to tokens and what it is to kinds.
+		// comments are skipped, string and character literals become a single token. every #include is appended to includes
+		void Tokenize(std::vector<Token>& tokens, std::vector<TokenKind>& kinds, std::vector<IncludeDirective>& includes);
+
+	private:
+		// whitespace seperates tokens but is never part of one
+		static inline bool IsSpace(char c);
+
+		// the kind of a single character structural token
+		static inline TokenKind GetPunctuationKind(char c);
+
+		// checks if the characters in [start, mPosition) are a literal prefix ie u8, L, R, u8R
+		inline bool IsLiteralPrefix(size_t start) const;
+
+		// appends an include if the newest token is the path of #include, # include or #include<path>
+		static inline void RecordInclude(const std::vector<Token>& tokens, std::vector<IncludeDirective>& includes);
+
+	private:
+		std::string_view mSource;
+
+		const SourceMasks& mMasks;
+
+		size_t mPosition;
+	};
+} // namespace gep
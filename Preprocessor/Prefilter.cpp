@@ -0,0 +1,240 @@
+/*****************************************************************//**
+ * \file   Prefilter.cpp
+ * \brief
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+// std
+#include <array>
+#include <cstring>
+#include <string>
+
+// simdjson
+#include <simdjson.h>
+
+// this
+#include "Prefilter.hpp"
+
+#include "Keywords.hpp"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define GEP_PREFILTER_X86
+#include <immintrin.h>
+#endif
+
+// msvc allows any intrinsic anywhere, gcc and clang need the target per function
+#if defined(_MSC_VER) && !defined(__clang__)
+#define GEP_TARGET(isa)
+#else
+#define GEP_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace gep
+{
+    namespace
+    {
+        /////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// the needles, every keyword registered with the meta role
+
+        constexpr size_t CountNeedles()
+        {
+            size_t count = 0;
+            for (const KeywordInfo& keyword : sKeywords)
+            {
+                if (keyword.mRole == KeywordRole::Meta) count++;
+            }
+
+            return count;
+        }
+
+        constexpr size_t sNeedleCount = CountNeedles();
+
+        constexpr std::array<std::string_view, sNeedleCount> BuildNeedles()
+        {
+            std::array<std::string_view, sNeedleCount> needles = {};
+
+            size_t count = 0;
+            for (const KeywordInfo& keyword : sKeywords)
+            {
+                if (keyword.mRole == KeywordRole::Meta) needles[count++] = keyword.mText;
+            }
+
+            return needles;
+        }
+
+        constexpr std::array<std::string_view, sNeedleCount> sNeedles = BuildNeedles();
+
+        constexpr size_t LongestNeedle()
+        {
+            size_t longest = 0;
+            for (const std::string_view needle : sNeedles)
+            {
+                if (needle.length() > longest) longest = needle.length();
+            }
+
+            return longest;
+        }
+
+        constexpr size_t ShortestNeedle()
+        {
+            size_t shortest = sNeedles[0].length();
+            for (const std::string_view needle : sNeedles)
+            {
+                if (needle.length() < shortest) shortest = needle.length();
+            }
+
+            return shortest;
+        }
+
+        constexpr size_t sLongestNeedle = LongestNeedle();
+
+        // the simd kernels compare the first and last character of a needle, so every needle needs two
+        static_assert(sNeedleCount > 0, "the prefilter needs at least one meta keyword");
+        static_assert(ShortestNeedle() >= 2, "meta keywords must be at least 2 characters long");
+
+        // index of the lowest set bit, mask must not be 0
+        inline unsigned LowestBit(uint32_t mask)
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return index;
+#else
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+        }
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// kernels, each one answers for the whole source
+
+        // the library search skips to each first character with memchr
+        bool ScalarKernel(std::string_view source)
+        {
+            for (const std::string_view needle : sNeedles)
+            {
+                if (source.find(needle) != std::string_view::npos) return true;
+            }
+
+            return false;
+        }
+
+        // checks the candidates of one needle, bit i of candidates is a match of the first and last character at position + i
+        inline bool VerifyCandidates(const char* position, std::string_view needle, uint32_t candidates)
+        {
+            while (candidates)
+            {
+                const unsigned offset = LowestBit(candidates);
+                if (std::memcmp(position + offset + 1, needle.data() + 1, needle.length() - 2) == 0) return true;
+
+                candidates &= candidates - 1;
+            }
+
+            return false;
+        }
+
+#ifdef GEP_PREFILTER_X86
+        // compares the first and last character of every needle 32 positions at a time, only positions where both match are verified
+        GEP_TARGET("avx2")
+        bool Avx2Kernel(std::string_view source)
+        {
+            const char* data = source.data();
+            const size_t length = source.length();
+
+            __m256i firsts[sNeedleCount];
+            __m256i lasts[sNeedleCount];
+            for (size_t n = 0; n < sNeedleCount; n++)
+            {
+                firsts[n] = _mm256_set1_epi8(sNeedles[n].front());
+                lasts[n] = _mm256_set1_epi8(sNeedles[n].back());
+            }
+
+            size_t i = 0;
+            for (; i + 32 + sLongestNeedle - 1 <= length; i += 32)
+            {
+                const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+
+                for (size_t n = 0; n < sNeedleCount; n++)
+                {
+                    const __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + sNeedles[n].length() - 1));
+                    const __m256i match = _mm256_and_si256(_mm256_cmpeq_epi8(block, firsts[n]), _mm256_cmpeq_epi8(blockLast, lasts[n]));
+
+                    const uint32_t candidates = static_cast<uint32_t>(_mm256_movemask_epi8(match));
+                    if (candidates && VerifyCandidates(data + i, sNeedles[n], candidates)) return true;
+                }
+            }
+
+            // a needle starting before i was already seen in full by the loop
+            return ScalarKernel(source.substr(i));
+        }
+
+        GEP_TARGET("sse4.2")
+        bool Sse42Kernel(std::string_view source)
+        {
+            const char* data = source.data();
+            const size_t length = source.length();
+
+            __m128i firsts[sNeedleCount];
+            __m128i lasts[sNeedleCount];
+            for (size_t n = 0; n < sNeedleCount; n++)
+            {
+                firsts[n] = _mm_set1_epi8(sNeedles[n].front());
+                lasts[n] = _mm_set1_epi8(sNeedles[n].back());
+            }
+
+            size_t i = 0;
+            for (; i + 16 + sLongestNeedle - 1 <= length; i += 16)
+            {
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+                for (size_t n = 0; n < sNeedleCount; n++)
+                {
+                    const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + sNeedles[n].length() - 1));
+                    const __m128i match = _mm_and_si128(_mm_cmpeq_epi8(block, firsts[n]), _mm_cmpeq_epi8(blockLast, lasts[n]));
+
+                    const uint32_t candidates = static_cast<uint32_t>(_mm_movemask_epi8(match));
+                    if (candidates && VerifyCandidates(data + i, sNeedles[n], candidates)) return true;
+                }
+            }
+
+            return ScalarKernel(source.substr(i));
+        }
+#endif
+    }
+
+    Prefilter::Prefilter()
+        : mKernel(&ScalarKernel)
+        , mKernelName("scalar")
+    {
+#ifdef GEP_PREFILTER_X86
+        // the same detection the classifier uses
+        const std::string implementation = simdjson::get_active_implementation()->name();
+
+        if (implementation == "icelake" || implementation == "haswell")
+        {
+            mKernel = &Avx2Kernel;
+            mKernelName = "avx2";
+        }
+        else if (implementation == "westmere")
+        {
+            mKernel = &Sse42Kernel;
+            mKernelName = "sse4.2";
+        }
+#endif
+    }
+
+    bool Prefilter::MayContainKeyword(std::string_view source) const
+    {
+        return mKernel(source);
+    }
+
+    const char* Prefilter::GetKernelName() const
+    {
+        return mKernelName;
+    }
+}
@@ -0,0 +1,70 @@
+/*****************************************************************//**
+ * \file   Prefilter.hpp
+ * \brief  one vectorized pass over the raw bytes of a file that decides
+ *         if it can contain any meta keyword, files that cannot are
+ *         never lexed
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <string_view>
+
+namespace gep
+{
+	// how much work the prefilter saved
+	struct PrefilterStats
+	{
+		size_t mFiles = 0;          // files the prefilter looked at
+		size_t mSkipped = 0;        // files without any meta keyword
+		uint64_t mBytes = 0;
+		uint64_t mSkippedBytes = 0;
+		double mFilterSeconds = 0;  // time spent in the prefilter
+		uint64_t mParsedBytes = 0;  // bytes that went through the full pipeline
+		double mParseSeconds = 0;   // time the full pipeline took for them
+
+		PrefilterStats& operator+=(const PrefilterStats& other)
+		{
+			mFiles += other.mFiles;
+			mSkipped += other.mSkipped;
+			mBytes += other.mBytes;
+			mSkippedBytes += other.mSkippedBytes;
+			mFilterSeconds += other.mFilterSeconds;
+			mParsedBytes += other.mParsedBytes;
+			mParseSeconds += other.mParseSeconds;
+			return *this;
+		}
+
+		// the full pipeline cost of the skipped bytes, less what the prefilter itself cost
+		double GetSecondsSaved() const
+		{
+			if (mParsedBytes == 0) return 0;
+
+			return mSkippedBytes * (mParseSeconds / mParsedBytes) - mFilterSeconds;
+		}
+	};
+
+	class Prefilter
+	{
+	public:
+		// picks the widest kernel the cpu supports
+		Prefilter();
+
+		// true if any keyword with the meta role appears anywhere in source, comments and literals included
+		bool MayContainKeyword(std::string_view source) const;
+
+		// the name of the kernel in use ie avx2
+		const char* GetKernelName() const;
+
+	private:
+		using Kernel = bool (*)(std::string_view source);
+
+		Kernel mKernel;
+
+		const char* mKernelName;
+	};
+} // namespace gep
@@ -16,54 +16,226 @@
 #include <limits>
 
 #include <stack>
+#include <algorithm>
+#include <cctype>
+#include <bit>
 
 // simdjson
 #include <simdjson.h>
 
 // allows pretty printing
 #include <Printing.hpp>
+#include <Serializing.hpp>
 
 #include <OutStream.hpp>
 
 // this
 #include "Preprocessor.hpp"
 
+#include "Profiler.hpp"
 #include "Timer.hpp"
 
+#ifdef _WIN32
 #include <ShlObj.h>
+#endif
 
 namespace gep
 {
+    namespace
+    {
+        // static members, references and anything declared with more than a name cannot be pointed at with a member pointer,
+        // so they are left out of field tables
+        bool HasMemberPointer(std::string_view type, std::string_view name)
+        {
+            const auto isIdentifier = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+
+            if (name.empty() || std::isdigit(static_cast<unsigned char>(name.front())) || !std::all_of(name.begin(), name.end(), isIdentifier)) return false;
+            if (!type.empty() && type.back() == '&') return false;
+
+            for (size_t begin = 0; begin < type.size();)
+            {
+                size_t end = begin;
+                while (end < type.size() && isIdentifier(type[end])) end++;
+
+                if (type.substr(begin, end - begin) == "static") return false;
+
+                begin = end + 1;
+            }
+
+            return true;
+        }
+
+        // the seed and mask the generated reader switches on
+        struct KeyBuckets
+        {
+            uint64_t mSeed;
+            uint64_t mMask;
+        };
+
+        // seeds tried for a class, so the search costs at most this many passes over the keys however many fields there are
+        constexpr uint64_t sSeedBudget = 64;
+
+        // the chance a random seed gives every key its own bucket, the birthday problem
+        double GetPerfectChance(size_t keyCount, uint64_t bucketCount)
+        {
+            double chance = 1.0;
+            for (size_t i = 1; i < keyCount && chance > 0.0; i++) chance *= 1.0 - static_cast<double>(i) / bucketCount;
+
+            return chance;
+        }
+
+        // searches for a seed of key_hash that gives every key its own bucket. the table is the smallest power of two, up to four
+        // times the keys, that the budget of seeds is likely to separate them in. when no seed is perfect the one with the fewest
+        // collisions is kept, keys that share a bucket are told apart by the compare every case makes anyway
+        KeyBuckets FindKeyBuckets(std::span<const std::string_view> keys, std::vector<uint8_t>& used)
+        {
+            const uint64_t minimum = std::bit_ceil(std::max<uint64_t>(keys.size(), 1));
+
+            uint64_t bucketCount = minimum;
+            while (bucketCount < minimum * 4 && GetPerfectChance(keys.size(), bucketCount) * sSeedBudget < 1.0) bucketCount *= 2;
+
+            KeyBuckets best = { 0, bucketCount - 1 };
+            size_t bestCollisions = keys.size();
+            for (uint64_t seed = 0; seed < sSeedBudget && bestCollisions > 0; seed++)
+            {
+                used.assign(bucketCount, 0);
+
+                // stops as soon as the seed is no better than the best one
+                size_t collisions = 0;
+                for (size_t i = 0; i < keys.size() && collisions < bestCollisions; i++)
+                {
+                    uint8_t& bucket = used[json::detail::key_hash(keys[i], seed) & (bucketCount - 1)];
+                    collisions += bucket;
+                    bucket = 1;
+                }
+
+                if (collisions < bestCollisions)
+                {
+                    best.mSeed = seed;
+                    bestCollisions = collisions;
+                }
+            }
+
+            return best;
+        }
+    }
+
     Preprocessor::Preprocessor()
+        : mMetaPath(".meta")
+        , mIsProjectMode(false)
+        , mCache(std::make_shared<Cache>())
+        , mIncludeGraph(nullptr)
     {
-        // preallocate some space for strings 
-        mRemovedStrings.reserve(1024llu);
+        // preallocate some space for tokens
+        mTokens.reserve(4096llu);
+        mTokenKinds.reserve(4096llu);
     }
 
     Preprocessor::~Preprocessor()
     {
     }
 
-    void Preprocessor::ReadConfig()
+    bool Preprocessor::ReadConfig()
+    {
+        simdjson::dom::parser parser;
+        simdjson::dom::element root;
+        if (parser.load(sConfigName).get(root))
+        {
+            gep::cerr << "Failed to parse " << sConfigName << std::endl;
+            return false;
+        }
+
+        Config config;
+
+        simdjson::dom::array extensions;
+        if (!root["FileExtensions"].get(extensions))
+        {
+            for (simdjson::dom::element extension : extensions)
+            {
+                std::string_view text;
+                if (!extension.get(text)) config.mFileExtensions.emplace_back(text);
+            }
+        }
+
+        simdjson::dom::array sourcePaths;
+        if (!root["AdditionalSourcePath"].get(sourcePaths))
+        {
+            for (simdjson::dom::element sourcePath : sourcePaths)
+            {
+                std::string_view text;
+                if (!sourcePath.get(text)) config.mSourcePaths.push_back(ToConfigPath(text));
+            }
+        }
+
+        std::string_view outputPath;
+        if (!root["OutputPath"].get(outputPath)) config.mOutputPath = ToConfigPath(outputPath);
+
+        SetConfig(config);
+
+        return true;
+    }
+
+    void Preprocessor::SetConfig(const Config& config)
+    {
+        mConfig = config;
+        mMetaPath = mConfig.mOutputPath / ".meta";
+        mIsProjectMode = true;
+    }
+
+    const Preprocessor::Config& Preprocessor::GetConfig() const
     {
-        //simdjson::dom::parser parser;
-        //simdjson::dom::element tweets = parser.load("pconfig.json");
+        return mConfig;
+    }
+
+    const std::filesystem::path& Preprocessor::GetMetaPath() const
+    {
+        return mMetaPath;
+    }
 
+    bool Preprocessor::IsProjectMode() const
+    {
+        return mIsProjectMode;
     }
 
     void Preprocessor::CreateConfig() const
     {
+        // the installer ships a template, otherwise one that scans for headers is written
+        const std::filesystem::path configTemplate = GetAppDataPath() / sConfigName;
+
+        std::error_code error;
+        if (std::filesystem::is_regular_file(configTemplate, error))
+        {
+            std::filesystem::copy_file(configTemplate, sConfigName, std::filesystem::copy_options::overwrite_existing, error);
+            if (!error) return;
+        }
+
+        std::ofstream config(sConfigName);
+        config << "{\n"
+                  "  \"FileExtensions\": \n"
+                  "  [\n"
+                  "    \".hpp\",\n"
+                  "    \".h\"\n"
+                  "  ],\n"
+                  "  \"AdditionalSourcePath\": \n"
+                  "  [\n"
+                  "  ],\n"
+                  "  \"OutputPath\": \"$(SolutionDir)\"\n"
+                  "}";
     }
 
     bool Preprocessor::HasConfig() const
     {
-        return false;
+        std::error_code error;
+        return std::filesystem::is_regular_file(sConfigName, error);
     }
 
-    void Preprocessor::InitializeMetaHeader() const
+    void Preprocessor::InitializeMetaHeader()
     {
         // create the meta folder if it doesnt exist 
-        std::filesystem::create_directory(".meta");
+        std::filesystem::create_directories(mMetaPath);
+
+        // outputs of previous runs, only valid for this version and keyword table
+        mCache->Open(mMetaPath / "cache", GetConfigHash());
 
         //SetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), ENABLE_VIRTUAL_TERMINAL_PROCESSING);
     }
@@ -80,19 +252,23 @@ namespace gep
             const std::filesystem::path& path = entry.path();
             if (entry.is_regular_file()) 
             {
-                std::filesystem::copy(path, pasteTo.string() + "\\" + path.filename().string(), std::filesystem::copy_options::overwrite_existing);
+                std::filesystem::copy(path, pasteTo / path.filename(), std::filesystem::copy_options::overwrite_existing);
                 gep::cout << path.filename() << std::endl;
             }
         }
 
     }
 
-    int Preprocessor::PreprocessFile(const std::filesystem::path& path)
+    int Preprocessor::PreprocessFile(const std::filesystem::path& path, bool isDependency)
     {
         // starts a timer to measure file process speed
         Timer timer;
         timer.Start();
 
+        // every stage below is nested inside of this one in the trace
+        ProfileScope fileScope(Stage::File);
+        if (Profiler::IsEnabled()) fileScope.SetDetail(path.string());
+
         mFilePath = path;
         
         // reads in the data from the given file
@@ -104,398 +280,557 @@ namespace gep
             return 1;
         }
 
-        // removes all of the comments from the file
-        RemoveComments();
+        fileScope.AddBytes(mFileContents.size());
 
-        if (path.filename().extension() == ".cpp")
+        // a project scan or an include finds headers on its own, the ones that do not opt in are skipped quietly
+        const bool isOptional = mIsProjectMode || isDependency;
+
+        // a project config asks for its extensions on purpose
+        if (!isOptional && path.filename().extension() == ".cpp")
         {
             gep::cwar << "File: " << path.filename() << " is a cpp file, should this be a header?" << std::endl;
             gep::cwar << "Path was: " << path << std::endl;
         }
 
-        // checks if the file read in has the needed include
-        if (!HasInclude("Reflection.hpp"))
+        // most headers have nothing to reflect, one pass over the raw bytes proves it without lexing
+        Timer filterTimer;
+        filterTimer.Start();
+        bool mayReflect;
         {
-            gep::cerr << "No reflection include was found for file: " << path.filename() << std::endl;
-            return 1;
+            ProfileScope filterScope(Stage::Prefilter, mFileContents.size());
+            mayReflect = mPrefilter.MayContainKeyword(mFileContents);
         }
+        mPrefilterStats.mFilterSeconds += filterTimer.Stop();
+        mPrefilterStats.mFiles++;
+        mPrefilterStats.mBytes += mFileContents.size();
 
-        // now checks if the meta file is included at thee bottom of the file
-        std::string metaFileName = mFilePath.filename().stem().string() + ".meta";
-        if (!HasInclude(metaFileName))// reflection include was found
+        std::string_view code;
+        bool isCached = false;
+
+        if (!mayReflect)
         {
-            gep::cerr << "No meta include was found at the bottom of file "<< mFilePath.filename() << std::endl
-                      << mFilePath.filename() << " must have \"#include <.meta/" << metaFileName << ">\" at the bottom of the file" << std::endl;
-            return 1;
-        }
+            // counted before a project scan returns early, those headers are most of what the prefilter saves
+            mPrefilterStats.mSkipped++;
+            mPrefilterStats.mSkippedBytes += mFileContents.size();
 
-        // masks all strings with '$'
-        MaskStrings();
+            // a project scan only writes meta files that something can include
+            const std::string metaFileName = mFilePath.filename().stem().string() + ".meta";
+            if (isOptional && mFileContents.find(metaFileName) == std::string_view::npos)
+            {
+                if (mIncludeGraph) PublishHeader(mayReflect);
+
+                Clear();
+                return 0;
+            }
 
-        // adds a bunch of padding and removes excess spaces
-        NormalizeSpaces();
+            // with nothing collected only the header of the file is written
+            GenerateCode();
+            code = mOutput.View();
+        }
+        else
+        {
+            // a header that was seen before with the same contents and config skips straight to writing
+            uint64_t cacheKey;
+            {
+                ProfileScope cacheScope(Stage::Cache, mFileContents.size());
+                cacheKey = mCache->GetKey(mFilePath.filename().string(), mFileContents);
+                isCached = mCache->Find(cacheKey, mScratch, mWarnings);
+            }
 
-        //tokenizes the fileContents
-        std::string token;
-        std::stringstream fCs(mFileContents);
-        while (fCs >> mTokens.emplace_back());
+            // the warnings of a cold run are printed again so a hit never hides them
+            if (isCached && !mWarnings.empty()) gep::cwar << mWarnings << std::flush;
 
-        CollectMetaData();
+            if (!isCached)
+            {
+                Timer parseTimer;
+                parseTimer.Start();
 
-        //gep::print(metaInfos);
+                const ParseResult parsed = ParseAndGenerate(isOptional);
+                if (parsed != ParseResult::Generated)
+                {
+                    if (mIncludeGraph) PublishHeader(mayReflect);
 
+                    Clear();
+                    return (parsed == ParseResult::Failed) ? 1 : 0;
+                }
 
+                mPrefilterStats.mParseSeconds += parseTimer.Stop();
+                mPrefilterStats.mParsedBytes += mFileContents.size();
 
-        // undoes MaskStrings()
-        RestoreStrings();
+                ProfileScope cacheScope(Stage::Cache, mOutput.View().size());
+                mCache->Store(cacheKey, mOutput.View(), mWarnings);
+            }
+
+            code = isCached ? std::string_view(mScratch) : mOutput.View();
+        }
 
         // creates the files
-        GenerateOutput();
+        const OutputResult result = GenerateOutput(code);
+
+        // the headers this one includes are followed by whoever runs the graph
+        if (mIncludeGraph) PublishHeader(mayReflect);
 
         // empties variables for multiple calls
         Clear();
-        gep::cout << "File: " << mFilePath.filename() << " completed in " + timer.AsString() << " seconds" << std::endl;
+
+        if (result == OutputResult::Failed)
+        {
+            gep::cerr << "Failed to write the meta file for: " << path.filename() << std::endl;
+            return 1;
+        }
+
+        gep::cout << "File: " << mFilePath.filename() << " completed in " + timer.AsString() << " seconds";
+        if (isCached) gep::cout << " from cache";
+        if (!mayReflect) gep::cout << ", nothing to reflect";
+        if (result == OutputResult::Unchanged) gep::cout << ", meta file unchanged";
+        gep::cout << std::endl;
 
         return 0;
     }
 
-    void Preprocessor::WriteFunctionDefinition(const MetaInfo& mi, const std::string& returnType, const std::string& functionPath, bool isConst)
+    inline Preprocessor::ParseResult Preprocessor::ParseAndGenerate(bool isOptional)
     {
+        Tokenize();
+
+        // checks if the file read in has the needed include
+        if (!HasInclude("Reflection.hpp"))
+        {
+            // a project scan finds every header, only the ones that opt in matter
+            if (isOptional) return ParseResult::Unreflected;
+
+            gep::cerr << "No reflection include was found for file: " << mFilePath.filename() << std::endl;
+            return ParseResult::Failed;
+        }
+
+        // now checks if the meta file is included at thee bottom of the file
+        std::string metaFileName = mFilePath.filename().stem().string() + ".meta";
+        if (!HasInclude(metaFileName))// reflection include was found
+        {
+            gep::cerr << "No meta include was found at the bottom of file "<< mFilePath.filename() << std::endl
+                      << mFilePath.filename() << " must have \"#include <.meta/" << metaFileName << ">\" at the bottom of the file" << std::endl;
+            return ParseResult::Failed;
+        }
+
+        CollectMetaData();
+        if (!mWarnings.empty()) gep::cwar << mWarnings << std::flush;
+
+        // writes every specialization into one buffer
+        GenerateCode();
+
+        return ParseResult::Generated;
     }
 
     inline bool Preprocessor::ReadFile(const std::filesystem::path& path)
     {
-        // opens a file
-        std::ifstream inFile(path);
-        if (!inFile.is_open()) return false;
+        ProfileScope readScope(Stage::Read);
+
+        // maps large files and reads small ones and pipes, either way the buffer is never copied again
+        if (!mSourceFile.Open(path)) return false;
 
-        //reads in all of the data from the file
-        mFileContents.assign((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
-        inFile.close();
+        mFileContents = mSourceFile.View();
+        readScope.AddBytes(mFileContents.size());
 
         return true;
     }
 
-    bool Preprocessor::HasInclude(const std::string& includeFile) const
+    inline void Preprocessor::Tokenize()
     {
-        // locates an include directive
-        const std::string includeString("#include");
-
-        // start searching for includes at the beginning of the file
-        size_t includePos = 0;
-        while (true)
+        // finds every literal and comment with the vectorized classifier
         {
-            // locate the next #include
-            includePos = mFileContents.find(includeString, includePos + 1);
-
-            // if a #include was not sucessfully found
-            if (includePos == std::string::npos) return false;
+            ProfileScope classifyScope(Stage::Classify, mFileContents.size());
+            mClassifier.Classify(mFileContents, mMasks);
+        }
 
-            // gets the start and end postion of the content inbetween the <> or ""
-            size_t includeStart = mFileContents.find_first_of("<\"", includePos + includeString.length()) + 1;
-            size_t includeEnd   = mFileContents.find_first_of(">\"", includeStart);
+        // tokenizes the file in a single pass, skipping comments and keeping literals whole
+        ProfileScope tokenizeScope(Stage::Tokenize, mFileContents.size());
 
-            // gets the string inbetween the <> or ""
-            std::string includeContents = mFileContents.substr(includeStart, includeEnd - includeStart);
+        Lexer lexer(mFileContents, mMasks);
+        lexer.Tokenize(mTokens, mTokenKinds, mIncludes);
 
-            // checks if the string contains the name of the reflection file
-            size_t reflectionPos = includeContents.find(includeFile);
+        tokenizeScope.AddTokens(mTokens.size());
+    }
 
-            // if the include pos 
-            if (reflectionPos != std::string::npos)
+    bool Preprocessor::HasInclude(const std::string& includeFile) const
+    {
+        // the lexer already found every directive
+        for (const IncludeDirective& include : mIncludes)
+        {
+            // checks if the path contains the name of the file
+            if (include.mPath.find(includeFile) != std::string_view::npos)
             {
                 return true;
             }
-
         }
 
         return false;
     }
 
-    void Preprocessor::MaskStrings()
+    inline std::filesystem::path Preprocessor::ResolveInclude(std::string_view include) const
     {
-        bool inQuotes = false;
-        bool prev = false;
+        const std::filesystem::path relative(include);
+
+        // meta files are generated from the header that includes them
+        if (relative.extension() == ".meta") return std::filesystem::path();
 
-        for (size_t i = 0; i < mFileContents.length(); i++)
+        // the directory of the including file first like a compiler, then the project
+        std::vector<std::filesystem::path> directories = { mFilePath.parent_path(), "." };
+        directories.insert(directories.end(), mConfig.mSourcePaths.begin(), mConfig.mSourcePaths.end());
+
+        for (const std::filesystem::path& directory : directories)
         {
-            prev = inQuotes;
-            if (mFileContents[i] == '"' 
-                && i != 0
-                && mFileContents[i - 1] != '\\')
-            {
-                inQuotes = !inQuotes;
-            }
+            const std::filesystem::path candidate = directory / relative;
 
-            if (inQuotes && prev)
-            {
-                mRemovedStrings.push_back(mFileContents[i]);
-                mFileContents[i] = '$';
-            }
+            std::error_code error;
+            if (std::filesystem::is_regular_file(candidate, error)) return candidate.lexically_normal();
         }
+
+        // most likely on an include path only the compiler knows about
+        return std::filesystem::path();
     }
 
-    void Preprocessor::RestoreStrings()
+    inline void Preprocessor::PublishHeader(bool mayReflect)
     {
-        bool inQuotes = false;
-        bool prev = false;
-        size_t currentIndex = 0;
+        ProfileScope publishScope(Stage::Publish);
 
-        for (size_t i = 0; i < mFileContents.length(); i++)
+        // cache hits and files the prefilter ruled out were never lexed
+        if (mTokens.empty())
         {
-            prev = inQuotes;
-            if (mFileContents[i] == '"'
-                && i != 0
-                && mFileContents[i - 1] != '\\')
-            {
-                inQuotes = !inQuotes;
-            }
+            Tokenize();
 
-            if (inQuotes && prev)
-            {
-                mFileContents[i] = mRemovedStrings.at(currentIndex);
-                currentIndex++;
-            }
+            if (mayReflect && HasInclude("Reflection.hpp")) CollectMetaData();
+        }
+
+        HeaderInfo info;
+
+        // system headers are never followed
+        for (const IncludeDirective& include : mIncludes)
+        {
+            if (include.mIsSystem) continue;
+
+            std::filesystem::path resolved = ResolveInclude(include.mPath);
+            if (!resolved.empty()) info.mIncludes.push_back(std::move(resolved));
+        }
+
+        info.mFields.reserve(mMetaInfos.size());
+        for (const MetaInfo& meta : mMetaInfos)
+        {
+            info.mFields.push_back({ std::string(mInterner.Lookup(meta.mFullClassPath)), std::string(mInterner.Lookup(meta.mType)),
+                                     std::string(mInterner.Lookup(meta.mVariableName)), meta.mFlags, meta.mNamespaceDepth, 1, meta.mOffset, meta.mLength });
+        }
+
+        // generating sorts the fields by class, file order is the same whether or not the cache was hit and lets lines be counted in one pass
+        std::sort(info.mFields.begin(), info.mFields.end(), [](const ReflectedField& a, const ReflectedField& b) { return a.mOffset < b.mOffset; });
+
+        size_t position = 0;
+        uint32_t line = 1;
+        for (ReflectedField& field : info.mFields)
+        {
+            line += static_cast<uint32_t>(std::count(mFileContents.begin() + position, mFileContents.begin() + field.mOffset, '\n'));
+            position = field.mOffset;
+            field.mLine = line;
         }
+
+        mIncludeGraph->Publish(mFilePath, std::move(info));
     }
 
-    // TODO: does not take into account charcters ie '"'
-    void Preprocessor::RemoveComments()
+    void Preprocessor::NormalizeSpaces(Token first, Token last, std::string& result) const
     {
-        // to determine whether or not im in a string, check the number of " that I have passed
-        // if ive passed an even number im not in a string, if ive passed an odd number I am in a string
+        const size_t begin = first.data() - mFileContents.data();
+        const size_t end = last.data() + last.length() - mFileContents.data();
 
-        // to count "
-        // if the quote is in a comment, ignore all quotes after a // or inbetween /* and */, add edge cases as needed
-        // 
+        ProfileScope normalizeScope(Stage::Normalize, end - begin);
 
-        bool inQuotes = false;
-        bool inCComment = false;
-        bool inCppComment = false;
-        bool nextLineComment = false;
+        // the result can never be longer than the source text
+        result.clear();
+        result.reserve(end - begin);
 
-        // loops through each character in the file
-        for (size_t i = 0; i < mFileContents.length(); i++)
+        bool pendingSpace = false;
+        for (size_t i = begin; i < end; i++)
         {
-            // case for comment start
-            if (mFileContents[i] == '/'             // could potentially be a comment
-                && (i + 1 < mFileContents.length()) // check if its the last character in the file
-                && !inQuotes                        // check if currently in quotes
-                && !(inCComment || inCppComment))   // check if currently inside of a comment)
+            const char c = mFileContents[i];
+
+            // literals are copied exactly
+            if (SourceMasks::Test(mMasks.mString, i))
             {
-                // checks what type of comment it is
-                if (mFileContents[i + 1] == '*')
-                {
-                    inCComment = true;
-                }
-                else if (mFileContents[i + 1] == '/')
-                {
-                    inCppComment = true;
-                }
+                result.push_back(c);
+                continue;
             }
-            
-            // case for quote start/end
-            else if (mFileContents[i] == '\"'     // checks if there is a quote
-                && (i != 0)                       // checks if its the first character in a file
-                && (mFileContents[i - 1] != '\\') // checks if the previous character is a '\'
-                && !(inCComment || inCppComment)) // check if currently inside of a comment
+
+            // comments and runs of whitespace become a single space
+            if (SourceMasks::Test(mMasks.mLineComment, i) || SourceMasks::Test(mMasks.mBlockComment, i)
+                || c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f')
             {
-                // all of those check are true then we are entering a quote or exiting a quote
-                inQuotes = !inQuotes;
+                pendingSpace = true;
+                continue;
             }
 
-            // case for c-comment end
-            else if (mFileContents[i] == '*'
-                && (i + 1 < mFileContents.length()) // checks if last character in file
-                && mFileContents[i + 1] == '/'      // checks if the following character is a '/' making */
-                && inCComment                       // must already be-inside a c-comment
-                && !inCppComment                    // must not be in a cpp comment
-                && !inQuotes)                       // must not be in quotes
-            {
-                // no longer in a comment
-                inCComment = false;
+            if (pendingSpace && !result.empty()) result.push_back(' ');
+            pendingSpace = false;
 
-                // remove the end of the c-comment
-                mFileContents[i] = ' ';
-                mFileContents[i + 1] = ' ';
-            }
+            result.push_back(c);
+        }
+    }
+
+    inline void Preprocessor::GenerateCode()
+    {
+        ProfileScope generateScope(Stage::Generate);
+
+        mOutput.Clear();
 
-            // case for cpp-comment end
-            else if (mFileContents[i] == '\n'
-                && (i != 0)           // checks if its the first character in a file
-                && inCppComment       // must be iside of a cpp comment
-                && !nextLineComment   // checks if the last character in the cpp comment '\'
-                && !inCComment        // must not be in a c comment
-                && !inQuotes)         // must not be in quotes
+        // adds pragma once for safe keeping
+        mOutput.Line("#pragma once");
+
+        // groups fields by class, fields keep their declaration order inside of a class
+        std::stable_sort(mMetaInfos.begin(), mMetaInfos.end(), [this](const MetaInfo& a, const MetaInfo& b)
             {
-                inCppComment = false;
-            }
+                return a.mFullClassPath != b.mFullClassPath && mInterner.Lookup(a.mFullClassPath) < mInterner.Lookup(b.mFullClassPath);
+            });
 
-            // case for newline cpp-comment start
-            else if (mFileContents[i] == '\\'
-                && inCppComment
-                && !inCComment
-                && !inQuotes)
+        for (size_t classFirst = 0; classFirst < mMetaInfos.size();)
+        {
+            size_t classLast = classFirst + 1;
+            while (classLast < mMetaInfos.size() && mMetaInfos[classLast].mFullClassPath == mMetaInfos[classFirst].mFullClassPath)
             {
-                nextLineComment = true;
+                classLast++;
             }
 
-            // case for newline cpp-comment end
-            else if (mFileContents[i] != '\\'
-                && nextLineComment)
+            const std::span<const MetaInfo> classFields(mMetaInfos.data() + classFirst, classLast - classFirst);
+
+            // each keyword becomes exactly one specialization holding the fields it marks
+            if (CollectKeyword(classFields, FieldPrintable))
             {
-                nextLineComment = false;
+                BuildPrinterTemplate(mKeywordFields);
             }
 
-            // where the characters are actually deleted
-            if (inCComment || inCppComment)
+            if (CollectKeyword(classFields, FieldSerializable))
             {
-                mFileContents[i] = ' ';
+                CollectSerializable(mKeywordFields);
+                BuildSerializingTemplate(mKeywordFields);
+                BuildBinaryTemplate(mKeywordFields);
+                BuildViewTemplate(mKeywordFields);
             }
-        }
-    }
-
-    void Preprocessor::NormalizeSpaces()
-    {
-        // adds padding to a bunch of differnt strings to aid in tokenization
-        AddPadding(mFileContents, ";");
-        AddPadding(mFileContents, "{");
-        AddPadding(mFileContents, "}");
-        AddPadding(mFileContents, "(");
-        AddPadding(mFileContents, ")");
-        AddPadding(mFileContents, "namespace");
-        AddPadding(mFileContents, "struct");
-        AddPadding(mFileContents, "class");
-        AddPadding(mFileContents, "=");
 
-        // keywords
-        AddPadding(mFileContents, "serializable");
-        AddPadding(mFileContents, "printable");
+            // one table per class no matter how many keywords it uses
+            BuildFieldTable(classFields);
 
-        // Note: cannot add a "\"" case because it would add spaces to the inside of a comment
+            classFirst = classLast;
+        }
 
-        // not necessary but should in theory make tokenization faster
-        RemoveExtraSpaces();
+        generateScope.AddBytes(mOutput.View().size());
     }
 
-    void Preprocessor::RemoveExtraSpaces()
+    inline bool Preprocessor::CollectKeyword(std::span<const MetaInfo> fields, uint32_t flag)
     {
-        // erases unnecessary spaces
-        char previous = '\0';
-        for (size_t i = 0; i < mFileContents.size();)
+        mKeywordFields.clear();
+        for (const MetaInfo& mi : fields)
         {
-            // if the previous and current character is a space remove one
-            if ((previous == ' ' || previous == '\t') && mFileContents[i] == ' ')
-            {
-                mFileContents.erase(i, 1);
-                continue;
-            }
-
-            // update previous
-            previous = mFileContents[i];
-            i++;
+            if (mi.mFlags & flag) mKeywordFields.push_back(mi);
         }
-    }
-
-    inline void Preprocessor::WriteLine(const MetaInfo& mi, size_t lineNumber, const std::string& line)
-    {
-        std::list<std::string>& lines = mClassMap[mi.mFullClassPath];
 
-        lines.insert(std::next(lines.begin(), lineNumber), line);
+        return !mKeywordFields.empty();
     }
 
-    void Preprocessor::BuildPrinterTemplate(const MetaInfo& mi)
+    void Preprocessor::BuildPrinterTemplate(std::span<const MetaInfo> fields)
     {
-        // if it already exists
-        bool existingClass = mClassMap.contains(mi.mFullClassPath);
+        const std::string_view classPath = mInterner.Lookup(fields.front().mFullClassPath);
 
-        std::string payload = "      gep::detail::build_and_run_printer(os, indent + 2, item." + mi.mVariableName + ") << std::endl;";
+        mOutput.Line("template<>struct gep::detail::Printer<", classPath, "> ");
+        mOutput.Line("{");
+        mOutput.Line("  static std::ostream& basic_print(std::ostream& os, size_t indent, const ", classPath, "& item)");
+        mOutput.Line("  {");
+        mOutput.Line("      gep::detail::out_color(\"{\", os, indent, color::GREEN) << std::endl;");
 
-        // write a print for the variable
-        if (existingClass)
+        // write a print for each variable
+        for (const MetaInfo& mi : fields)
         {
-            WriteLine(mi, 6, payload);
-        }
-        // otherwise generate a function for the entire class
-        else
-        {
-            WriteLine(mi, 0, "template<>struct gep::detail::Printer<"+mi.mFullClassPath+"> ");
-            WriteLine(mi, 1, "{");
-            WriteLine(mi, 2, "  static std::ostream& basic_print(std::ostream& os, size_t indent, const "+mi.mFullClassPath+"& item)");
-            WriteLine(mi, 3, "  {");
-            WriteLine(mi, 4, "      gep::detail::out_color(\"{\", os, indent, color::GREEN) << std::endl;");
-            WriteLine(mi, 5,        payload);
-            WriteLine(mi, 6, "      gep::detail::out_color(\"}\", os, indent, color::GREEN) << std::endl;");
-            WriteLine(mi, 7, "      return os;");
-            WriteLine(mi, 8, "  }");
-            WriteLine(mi, 9, "};");
+            mOutput.Line("      gep::detail::build_and_run_printer(os, indent + 2, item.", mInterner.Lookup(mi.mVariableName), ") << std::endl;");
         }
+
+        mOutput.Line("      gep::detail::out_color(\"}\", os, indent, color::GREEN) << std::endl;");
+        mOutput.Line("      return os;");
+        mOutput.Line("  }");
+        mOutput.Line("};");
     }
 
-    inline void Preprocessor::BuildSerializingTemplate(const MetaInfo& mi)
+    inline void Preprocessor::CollectSerializable(std::span<const MetaInfo> fields)
     {
-        // if it already exists
-        bool existingClass = mClassMap.contains(mi.mFullClassPath);
+        mSerialKeys.clear();
+        mSerialSchema = Hash64(mInterner.Lookup(fields.front().mFullClassPath));
 
-        std::list<std::string>& lines = mClassMap[mi.mFullClassPath];
+        for (const MetaInfo& mi : fields)
+        {
+            const std::string_view variableName = mInterner.Lookup(mi.mVariableName);
+            const std::string_view type = mInterner.Lookup(mi.mType);
+            if (!HasMemberPointer(type, variableName)) continue;
+            if (std::find(mSerialKeys.begin(), mSerialKeys.end(), variableName) != mSerialKeys.end()) continue;
 
-        auto write_FunctionDefinition = [&]() -> void
-            {
-                lines.push_back(std::string("template<> ") + "inline void gep::json::File::Read(" + mi.mFullClassPath + "& item) const" + "{");
-            };
+            mSerialKeys.push_back(variableName);
 
-        auto write_Header = [&]() -> void
-            {
-                lines.push_back(std::string("std::cout << \"") + mi.mFullClassPath + "\" << \":\" << std::endl;");
-            };
+            // chained so the order of the fields is part of the schema
+            mSerialSchema = Hash64(type, Hash64(variableName, mSerialSchema));
+        }
+    }
 
-        auto write_Contents = [&](size_t location) -> void
+    inline void Preprocessor::BuildSerializingTemplate(std::span<const MetaInfo> fields)
+    {
+        const std::string_view classPath = mInterner.Lookup(fields.front().mFullClassPath);
+
+        const KeyBuckets buckets = FindKeyBuckets(mSerialKeys, mBucketUsed);
+        const std::string seed = std::to_string(buckets.mSeed);
+        const std::string mask = std::to_string(buckets.mMask);
+
+        mOutput.Line("template<>struct gep::json::Reader<", classPath, "> ");
+        mOutput.Line("{");
+        mOutput.Line("  template<typename File>");
+        mOutput.Line("  static bool read(File& file, simdjson::ondemand::value value, ", classPath, "& item)");
+        mOutput.Line("  {");
+        mOutput.Line("      simdjson::ondemand::object object;");
+        mOutput.Line("      if (value.get_object().get(object)) return false;");
+        mOutput.Line("      for (auto result : object)");
+        mOutput.Line("      {");
+        mOutput.Line("          simdjson::ondemand::field field;");
+        mOutput.Line("          std::string_view key;");
+        mOutput.Line("          if (std::move(result).get(field) || field.unescaped_key().get(key)) return false;");
+        mOutput.Line("          switch (gep::json::detail::key_hash(key, ", seed, "ull) & ", mask, ")");
+        mOutput.Line("          {");
+
+        // one case per bucket, unknown keys fall through to default and are skipped
+        for (uint64_t bucket = 0; bucket <= buckets.mMask; bucket++)
+        {
+            bool isFirst = true;
+            for (std::string_view key : mSerialKeys)
             {
-                lines.insert(std::next(lines.begin(), location), std::string("std::cout << \"") + mi.mVariableName + " = \" << item." + mi.mVariableName + " << \":\" << std::endl;");
-            };
+                if ((json::detail::key_hash(key, buckets.mSeed) & buckets.mMask) != bucket) continue;
 
-        auto write_Finish = [&]() -> void
-            {
-                lines.push_back("}");
-            };
+                if (isFirst) mOutput.Append("          case ", std::to_string(bucket), ": ");
+                else         mOutput.Append(" else ");
 
-        if (existingClass)
-        {
-            write_Contents(2);
+                mOutput.Append("if (key == \"", key, "\") { if (!file.ReadValue(field.value(), item.", key, ")) return false; }");
+                isFirst = false;
+            }
+
+            if (!isFirst) mOutput.Line(" break;");
         }
-        else
+
+        mOutput.Line("          default: break;");
+        mOutput.Line("          }");
+        mOutput.Line("      }");
+        mOutput.Line("      return true;");
+        mOutput.Line("  }");
+        mOutput.Line("};");
+
+        mOutput.Line("template<>struct gep::json::Writer<", classPath, "> ");
+        mOutput.Line("{");
+        mOutput.Line("  template<typename File>");
+        mOutput.Line("  static void write(File& file, const ", classPath, "& item)");
+        mOutput.Line("  {");
+
+        // the punctuation and quoted name in front of every value is one literal
+        for (size_t i = 0; i < mSerialKeys.size(); i++)
         {
-            write_FunctionDefinition();
-            write_Header();
-            write_Contents(2);
-            write_Finish();
+            mOutput.Line("      file.WriteLiteral(\"", (i == 0) ? "{" : ",", "\\\"", mSerialKeys[i], "\\\":\");");
+            mOutput.Line("      file.WriteValue(item.", mSerialKeys[i], ");");
         }
 
-        //std::string result;
-        //// converts the list into a string
-        //for (const std::string& line : lines) result += "\n" + line;
-
-        //return result;
-
+        mOutput.Line(mSerialKeys.empty() ? "      file.WriteLiteral(\"{}\");" : "      file.WriteLiteral(\"}\");");
+        mOutput.Line("  }");
+        mOutput.Line("};");
     }
     
-    void Preprocessor::AddPadding(std::string& fileContents, const std::string& padword) const
+    inline void Preprocessor::BuildBinaryTemplate(std::span<const MetaInfo> fields)
+    {
+        const std::string_view classPath = mInterner.Lookup(fields.front().mFullClassPath);
+
+        // partial so the schema of a nested class is only looked up once the codec is used, by then every class is specialized
+        mOutput.Line("template<typename Type> requires std::same_as<Type, ", classPath, ">");
+        mOutput.Line("struct gep::binary::Codec<Type> ");
+        mOutput.Line("{");
+        mOutput.Line("  static constexpr uint64_t schema(size_t depth)");
+        mOutput.Line("  {");
+
+        // the text of the fields covers names and order, the types are mixed in by the compiler so nested layouts are covered too
+        mOutput.Append("      return gep::binary::detail::class_schema<");
+        for (size_t i = 0; i < mSerialKeys.size(); i++) mOutput.Append((i == 0) ? "decltype(Type::" : ", decltype(Type::", mSerialKeys[i], ")");
+        mOutput.Line(">(", std::to_string(mSerialSchema), "ull, depth);");
+
+        mOutput.Line("  }");
+        mOutput.Line("  template<typename Encoder>");
+        mOutput.Line("  static void encode(Encoder& encoder, const ", classPath, "& item)");
+        mOutput.Line("  {");
+
+        // one call with every field so the encoder can merge the raw ones that sit next to each other
+        mOutput.Append("      encoder.Fields(");
+        for (size_t i = 0; i < mSerialKeys.size(); i++) mOutput.Append((i == 0) ? "item." : ", item.", mSerialKeys[i]);
+        mOutput.Line(");");
+
+        mOutput.Line("  }");
+        mOutput.Line("  template<typename Decoder>");
+        mOutput.Line("  static bool decode(Decoder& decoder, ", classPath, "& item)");
+        mOutput.Line("  {");
+
+        mOutput.Append("      return decoder.Fields(");
+        for (size_t i = 0; i < mSerialKeys.size(); i++) mOutput.Append((i == 0) ? "item." : ", item.", mSerialKeys[i]);
+        mOutput.Line(");");
+
+        mOutput.Line("  }");
+        mOutput.Line("};");
+    }
+
+    inline void Preprocessor::BuildViewTemplate(std::span<const MetaInfo> fields)
     {
-        size_t location = 0;
-        while (true)
+        const std::string_view classPath = mInterner.Lookup(fields.front().mFullClassPath);
+
+        // partial so nothing is instantiated until the class is viewed, the fields become template arguments so their slots are laid out at compile time
+        mViewTable.clear();
+        mViewTable.append("gep::binary::TableView<Type");
+        for (const std::string_view key : mSerialKeys) mViewTable.append(", &Type::").append(key);
+        mViewTable.append(">");
+
+        mOutput.Line("template<typename Type> requires std::same_as<Type, ", classPath, ">");
+        mOutput.Line("struct gep::binary::View<Type> : ", mViewTable);
+        mOutput.Line("{");
+        mOutput.Line("  using Table = ", mViewTable, ";");
+        mOutput.Line("  using Table::Table;");
+
+        // deduced when first called, by then the view of a nested class is complete
+        for (size_t i = 0; i < mSerialKeys.size(); i++)
         {
-            location = fileContents.find(padword, location);
+            mOutput.Line("  auto ", mSerialKeys[i], "() const { return this->template Get<", std::to_string(i), ">(); }");
+        }
+
+        mOutput.Line("};");
+    }
+
+    inline void Preprocessor::BuildFieldTable(std::span<const MetaInfo> fields)
+    {
+        const std::string_view classPath = mInterner.Lookup(fields.front().mFullClassPath);
+
+        // the table follows the declarations
+        mFieldOrder.clear();
+        for (const MetaInfo& mi : fields) mFieldOrder.push_back(&mi);
+
+        std::sort(mFieldOrder.begin(), mFieldOrder.end(), [](const MetaInfo* a, const MetaInfo* b) { return a->mOffset < b->mOffset; });
+
+        mOutput.Line("template<>struct gep::detail::Fields<", classPath, "> ");
+        mOutput.Line("{");
+        mOutput.Line("  static constexpr auto fields = std::make_tuple(");
 
-            if (location == std::string::npos) break;
+        bool isFirst = true;
+        for (const MetaInfo* mi : mFieldOrder)
+        {
+            if (!HasMemberPointer(mInterner.Lookup(mi->mType), mInterner.Lookup(mi->mVariableName))) continue;
 
-            // insert a space after
-            fileContents.insert(location + padword.length(), " ");
+            // a field marked by both keywords is one entry with both flags
+            static constexpr std::string_view sFlags[] = { "0u", "gep::field_printable", "gep::field_serializable", "gep::field_printable | gep::field_serializable" };
 
-            // insert a space before
-            fileContents.insert(location, " ");
+            const std::string_view variableName = mInterner.Lookup(mi->mVariableName);
 
-            location += 2;
+            mOutput.Line(isFirst ? "      " : "    , ", "gep::make_field(\"", variableName, "\", &", classPath, "::", variableName, ", ", sFlags[mi->mFlags & 3u], ")");
+            isFirst = false;
         }
+
+        mOutput.Line("  );");
+        mOutput.Line("};");
     }
 
     size_t Preprocessor::FindFirstString(const std::string& fileContents, const std::vector<std::string>& strings, size_t start) const
@@ -515,146 +850,260 @@ namespace gep
         return found;
     }
 
-    inline void Preprocessor::GenerateOutput() const
+    inline Preprocessor::OutputResult Preprocessor::GenerateOutput(std::string_view code) const
     {
-        // the meta directory should exist becuase of the initialization call, then create the meta file
+        ProfileScope outputScope(Stage::Output, code.size());
+
+        // the meta directory should exist becuase of the initialization call
         std::string metaFileName = mFilePath.filename().stem().string() + ".meta";
-        std::ofstream outFile(".meta\\" + metaFileName);
+        const std::filesystem::path metaPath = mMetaPath / metaFileName;
+
+        // rewriting an identical file would still bump its timestamp and rebuild everything that includes it
+        SourceFile existing;
+        if (existing.Open(metaPath))
+        {
+            const std::string_view previous = existing.View();
+            if (previous.size() == code.size() && Hash64(previous) == Hash64(code)) return OutputResult::Unchanged;
+        }
+        existing.Close();
 
-        // adds pragma once for safe keeping and the include for the definition
-        outFile << "#pragma once\n";
+        // written next to the real file then renamed over it, so a reader never sees half a file
+        std::filesystem::path tempPath = metaPath;
+        tempPath += ".tmp";
 
-        // loops through all of the print objects writing the function out to the file for each
-        for (const auto& lines : mClassMap)
         {
-            for (const auto& line : lines.second)
-            {
-                outFile << line << "\n";
-            }
+            std::ofstream outFile(tempPath, std::ios::binary);
+            outFile.write(code.data(), static_cast<std::streamsize>(code.size()));
+            if (!outFile.flush()) return OutputResult::Failed;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, metaPath, error);
+        if (error)
+        {
+            std::filesystem::remove(tempPath, error);
+            return OutputResult::Failed;
         }
+
+        return OutputResult::Written;
     }
 
     inline void Preprocessor::CollectMetaData()
     {
-        // the keywords that are recognized
-        const std::unordered_set<std::string> metaKeyWords = { "printable", "serializable" };
+        ProfileScope collectScope(Stage::Collect, mFileContents.size());
+        collectScope.AddTokens(mTokens.size());
 
-        // helpers to maintain scope
-        std::unordered_set<std::string> namedScopes = { "class", "namespace", "struct" };
-        std::vector<std::string> scopeNames;
+        // helpers to maintain scope, the name and full path of each named scope
+        std::vector<StringId> scopeNames;
+        std::vector<StringId> scopePaths;
+        std::vector<TokenKind> scopeKinds;
         size_t currentScopeLevel = 0;
 
-        // the collected meta info from each variable
-        std::vector<MetaInfo> metaInfos;
+        // named scopes that are namespaces
+        uint32_t namespaceDepth = 0;
+
+        // reused to build each scope path before it is interned
+        std::string scopePath;
 
         // creates a MetaInfo vector
         for (size_t i = 0; i < mTokens.size(); i++)
         {
-            //if (mTokens[i] == "template")
-            //{
-            //    // move past "template" keyword, assuming valid syntax, guarenteed to be a "<"
-            //    i++;
-
-            //    int triangleBracketStack = 0;
-
-            //    do
-            //    {
-            //             if (mTokens[i] == "<") triangleBracketStack++;
-            //        else if (mTokens[i] == ">") triangleBracketStack--;
-            //        i++;
-            //    } 
-            //    while (triangleBracketStack);
-
-            //    // after continuing the i++ in the for loop will be called i-- prevents that
-            //    i--;
-            //    continue;
-            //}
+            // the keyword was recognized while lexing
+            const TokenKind kind = mTokenKinds[i];
+
             // maintains the current scope
-            if (mTokens[i] == "{")
+            if (kind == TokenKind::OpenBrace)
             {
                 // if a scope was named add it name to the current scope
-                if (namedScopes.contains(mTokens[i - 2]))
+                if (i >= 2 && HasKeywordRole(mTokenKinds[i - 2], KeywordRole::Scope))
                 {
-                    scopeNames.emplace_back(mTokens[i - 1]);
+                    scopePath.clear();
+                    if (!scopePaths.empty()) scopePath.append(mInterner.Lookup(scopePaths.back())).append("::");
+                    scopePath.append(mTokens[i - 1]);
+
+                    scopeNames.push_back(mInterner.Intern(mTokens[i - 1]));
+                    scopePaths.push_back(mInterner.Intern(scopePath));
+                    scopeKinds.push_back(mTokenKinds[i - 2]);
+
+                    if (scopeKinds.back() == TokenKind::Namespace) namespaceDepth++;
                 }
 
                 currentScopeLevel++;
                 continue;
             }
             
-            if (mTokens[i] == "}")
+            if (kind == TokenKind::CloseBrace)
             {
                 // if the current scope is a named scope remove it
-                if (currentScopeLevel == scopeNames.size())
+                if (currentScopeLevel == scopeNames.size() && !scopeNames.empty())
                 {
+                    if (scopeKinds.back() == TokenKind::Namespace) namespaceDepth--;
+
                     scopeNames.pop_back();
+                    scopePaths.pop_back();
+                    scopeKinds.pop_back();
                 }
 
-                currentScopeLevel--;
+                if (currentScopeLevel) currentScopeLevel--;
                 continue;
             }
 
             // must be inside of a class
-            if (currentScopeLevel != scopeNames.size()) continue;
+            if (currentScopeLevel != scopeNames.size() || scopeNames.empty()) continue;
 
             // token must be recognized
-            if (!metaKeyWords.contains(mTokens[i])) continue;
-
-            // creats a meta info object
-            MetaInfo& meta = metaInfos.emplace_back();
+            if (!HasKeywordRole(kind, KeywordRole::Meta)) continue;
 
-            meta.mKeyWord = *metaKeyWords.find(mTokens[i]);
+            // sets its class to the current scope and the full class path to all previous scopes
+            MetaInfo field = {};
+            field.mParentName = scopeNames.back();
+            field.mFullClassPath = scopePaths.back();
+            field.mNamespaceDepth = namespaceDepth;
 
-            // sets its class to the current scope
-            meta.mParentName = scopeNames.back();
-
-            // sets the full class path to all previous scopes
-            for (int j = 0; j < scopeNames.size() - 1; j++)
+            // every keyword in front of the declaration, printable serializable int x; is one field with both flags
+            for (; i < mTokens.size() && HasKeywordRole(mTokenKinds[i], KeywordRole::Meta); i++)
             {
-                meta.mFullClassPath += scopeNames[j] + "::";
+                field.mFlags |= GetFieldFlag(mTokenKinds[i]);
             }
-            meta.mFullClassPath += meta.mParentName;
-
-            // move past 'keyword'
-            i++;
 
-            // collect all variable specifiers
-            std::vector<std::string> variableInfo;
-            while (mTokens[i] != ";" && mTokens[i] != "=")
+            // the declaration runs to the ; outside of any braces so brace initializers are part of it
+            const size_t first = i;
+            size_t braceDepth = 0;
+            bool isClassEnd = false;
+            for (; i < mTokens.size(); i++)
             {
-                variableInfo.push_back(mTokens[i]);
-                i++;
+                if (mTokenKinds[i] == TokenKind::OpenBrace) braceDepth++;
+                else if (mTokenKinds[i] == TokenKind::CloseBrace)
+                {
+                    // the end of the class, the } is left for the scope tracking above
+                    isClassEnd = !braceDepth;
+                    if (isClassEnd) break;
+
+                    // a body that is not followed by ; or another declarator belonged to a function
+                    if (!--braceDepth && i + 1 < mTokens.size() && mTokenKinds[i + 1] != TokenKind::Semicolon && mTokens[i + 1].front() != ',')
+                    {
+                        break;
+                    }
+                }
+                else if (!braceDepth && mTokenKinds[i] == TokenKind::Semicolon) break;
             }
 
-            // the last item in the variableinfo will always be the variable name
-            meta.mVariableName = variableInfo.back();
-
-            // everything else is the type of the varible
-            for (int j = 0; j < variableInfo.size() - 1; j++)
+            // a keyword with nothing after it is not a declaration
+            if (i > first)
             {
-                meta.mType += variableInfo[j] + " ";
+                const size_t begin = mTokens[first].data() - mFileContents.data();
+                const size_t end = mTokens[i - 1].data() + mTokens[i - 1].length() - mFileContents.data();
+
+                CollectDeclarators(begin, end, field);
             }
+
+            // the } closing the class is looked at again so the scope ends
+            if (isClassEnd) i--;
         }
 
-        // loop through all meta info and generate a template function for them
-        for (int i = 0; i < metaInfos.size(); i++)
-        {
-            if (metaInfos[i].mKeyWord == "printable")
+    }
+
+    inline void Preprocessor::CollectDeclarators(size_t begin, size_t end, const MetaInfo& field)
+    {
+        const auto isIdentifier = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+        const auto isSkipped = [this](size_t i) { return SourceMasks::Test(mMasks.mString, i) || SourceMasks::Test(mMasks.mLineComment, i) || SourceMasks::Test(mMasks.mBlockComment, i); };
+
+        // int* a, *b; gives b the type in front of the first declarator without its * and &
+        std::string baseType;
+        bool isFirst = true;
+
+        // adds the declarator from start up to its initializer, one with parentheses is a function or a function pointer
+        const auto addDeclarator = [&](size_t start, size_t stop, bool hasParentheses)
             {
-                BuildPrinterTemplate(metaInfos[i]);
-            }
-            else if (metaInfos[i].mKeyWord == "serializable")
+                while (stop > start && (std::isspace(static_cast<unsigned char>(mFileContents[stop - 1])) || isSkipped(stop - 1))) stop--;
+                while (start < stop && (std::isspace(static_cast<unsigned char>(mFileContents[start])) || isSkipped(start))) start++;
+
+                size_t name = stop;
+                while (name > start && isIdentifier(mFileContents[name - 1])) name--;
+
+                // arrays, functions and anything else not ending in a name cannot be pointed at or read by name
+                if (name == stop || hasParentheses || std::isdigit(static_cast<unsigned char>(mFileContents[name])))
+                {
+                    NormalizeSpaces(mFileContents.substr(start, 1), mFileContents.substr(stop - 1, 1), mScratch);
+                    mWarnings.append("File: \"").append(mFilePath.filename().string()).append("\" line ").append(std::to_string(GetLine(start)))
+                             .append(": \"").append(mScratch).append("\" cannot be reflected, only fields declared with a plain name are\n");
+                    return;
+                }
+
+                if (name > start) NormalizeSpaces(mFileContents.substr(start, 1), mFileContents.substr(name - 1, 1), mScratch);
+                else              mScratch.clear();
+
+                if (isFirst)
+                {
+                    baseType = mScratch;
+                    while (!baseType.empty() && (baseType.back() == '*' || baseType.back() == '&' || baseType.back() == ' ')) baseType.pop_back();
+                }
+                else
+                {
+                    mScratch.insert(0, baseType);
+                }
+                isFirst = false;
+
+                MetaInfo& meta = mMetaInfos.emplace_back(field);
+                meta.mVariableName = mInterner.Intern(mFileContents.substr(name, stop - name));
+                meta.mType = mInterner.Intern(mScratch);
+
+                // where the declarator sits in the file
+                meta.mOffset = static_cast<uint32_t>(start);
+                meta.mLength = static_cast<uint32_t>(stop - start);
+            };
+
+        // commas only split declarators outside of template arguments, parentheses and braces
+        size_t angleDepth = 0;
+        size_t depth = 0;
+        size_t start = begin;
+        size_t initializer = end;
+        bool hasParentheses = false;
+
+        for (size_t i = begin; i < end; i++)
+        {
+            if (isSkipped(i)) continue;
+
+            switch (mFileContents[i])
             {
-                BuildSerializingTemplate(metaInfos[i]);
+            case '<': angleDepth++; break;
+            case '>': if (angleDepth) angleDepth--; break;
+            case '(': hasParentheses |= initializer == end; depth++; break;
+            case ')': if (depth) depth--; break;
+            case '{': if (!depth && !angleDepth && initializer == end) initializer = i; depth++; break;
+            case '}': if (depth) depth--; break;
+            case '=': if (!depth && !angleDepth && initializer == end) initializer = i; break;
+            case ',':
+                if (depth || angleDepth) break;
+
+                addDeclarator(start, std::min(initializer, i), hasParentheses);
+                start = i + 1;
+                initializer = end;
+                hasParentheses = false;
+                break;
             }
         }
+
+        addDeclarator(start, std::min(initializer, end), hasParentheses);
+    }
+
+    inline uint32_t Preprocessor::GetLine(size_t offset) const
+    {
+        return static_cast<uint32_t>(std::count(mFileContents.begin(), mFileContents.begin() + offset, '\n')) + 1;
     }
 
     inline void Preprocessor::Clear()
     {
-        mClassMap.clear();
-        mRemovedStrings.clear();
+        mMetaInfos.clear();
+        mWarnings.clear();
+        mOutput.Clear();
         mTokens.clear();
+        mTokenKinds.clear();
+        mIncludes.clear();
+
+        // tokens pointed into the file so they must be cleared first
+        mFileContents = {};
+        mSourceFile.Close();
     }
 
     inline std::filesystem::path Preprocessor::GetAppDataPath() const
@@ -662,6 +1111,7 @@ namespace gep
         std::string folderName = "gep";
         std::string programName = "preprocessor";
 
+#ifdef _WIN32
         PWSTR pathTemp;
 
         if (SUCCEEDED(SHGetKnownFolderPath(FOLDERID_ProgramData, 0, nullptr, &pathTemp)))
@@ -676,6 +1126,10 @@ namespace gep
         gep::cerr << "Failed to locate users appdata folder";
 
         return std::filesystem::path();
+#else
+        // the installer puts shared files in the same place on every unix like system
+        return std::filesystem::path("/usr/local/share").append(folderName).append(programName);
+#endif
     }
 
     inline void Preprocessor::CreateAppDataFolder() const
@@ -691,12 +1145,101 @@ namespace gep
         }
     }
 
-    std::ostream& operator<<(std::ostream& os, const Preprocessor::MetaInfo& info)
+    const PrefilterStats& Preprocessor::GetPrefilterStats() const
+    {
+        return mPrefilterStats;
+    }
+
+    bool Preprocessor::ReflectFile(const std::filesystem::path& path)
+    {
+        ProfileScope fileScope(Stage::File);
+        if (Profiler::IsEnabled()) fileScope.SetDetail(path.string());
+
+        mFilePath = path;
+        if (!ReadFile(path)) return false;
+
+        fileScope.AddBytes(mFileContents.size());
+
+        // the cache holds generated code, not fields, so there is nothing to skip to
+        if (mIncludeGraph)
+        {
+            bool mayReflect;
+            {
+                ProfileScope filterScope(Stage::Prefilter, mFileContents.size());
+                mayReflect = mPrefilter.MayContainKeyword(mFileContents);
+            }
+
+            PublishHeader(mayReflect);
+        }
+
+        Clear();
+        return true;
+    }
+
+    void Preprocessor::ShareCache(const Preprocessor& other)
+    {
+        mCache = other.mCache;
+    }
+
+    void Preprocessor::SetIncludeGraph(IncludeGraph* graph)
+    {
+        mIncludeGraph = graph;
+    }
+
+    void Preprocessor::FlushCache()
+    {
+        mCache->Flush();
+    }
+
+    void Preprocessor::PrintCacheStats()
+    {
+        // the index only knows its final size once pending entries are merged
+        mCache->Flush();
+
+        const CacheStats stats = mCache->GetStats();
+        gep::cout << "Cache: " << stats.mHits << " hits, " << stats.mMisses << " misses, "
+                  << stats.mStores << " stored, " << stats.mEvictions << " evicted, "
+                  << mCache->GetEntryCount() << " entries using " << mCache->GetByteCount() << " bytes" << std::endl;
+    }
+
+    inline std::filesystem::path Preprocessor::ToConfigPath(std::string_view text)
+    {
+        // visual studio macros end in a separator, every one of them means the directory of the config
+        std::string path(text);
+        for (const std::string_view macro : { "$(SolutionDir)", "$(ProjectDir)" })
+        {
+            for (size_t found = path.find(macro); found != std::string::npos; found = path.find(macro))
+            {
+                path.erase(found, macro.length());
+            }
+        }
+
+#ifndef _WIN32
+        // configs are written on windows
+        std::replace(path.begin(), path.end(), '\\', '/');
+#endif
+
+        return std::filesystem::path(path);
+    }
+
+    inline uint64_t Preprocessor::GetConfigHash() const
+    {
+        uint64_t hash = Hash64(sPreprocessorVersion);
+        for (const KeywordInfo& keyword : sKeywords)
+        {
+            hash = Hash64(keyword.mText, hash);
+            hash = Hash64(&keyword.mRole, sizeof(keyword.mRole), hash);
+        }
+
+        return hash;
+    }
+
+    std::ostream& Preprocessor::PrintMetaInfo(std::ostream& os, const MetaInfo& info) const
     {
-        os << "Type = "  << info.mType          << std::endl;
-        os << "Name = "  << info.mVariableName  << std::endl;
-        os << "Path = "  << info.mFullClassPath << std::endl;
-        os << "Class = " << info.mParentName    << std::endl;
+        os << "Type = "  << mInterner.Lookup(info.mType)          << std::endl;
+        os << "Name = "  << mInterner.Lookup(info.mVariableName)  << std::endl;
+        os << "Path = "  << mInterner.Lookup(info.mFullClassPath) << std::endl;
+        os << "Class = " << mInterner.Lookup(info.mParentName)    << std::endl;
 
         return os;
     }
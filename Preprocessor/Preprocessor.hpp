@@ -10,11 +10,24 @@
 
 // std
 #include <vector> 
-#include <list>
-#include <map>
+#include <span>
 #include <string>
 #include <filesystem>
 #include <iostream>
+#include <memory>
+#include <string_view>
+
+// preprocessor
+#include "Cache.hpp"
+#include "CodeWriter.hpp"
+#include "Hash.hpp"
+#include "IncludeGraph.hpp"
+#include "Interner.hpp"
+#include "Keywords.hpp"
+#include "Lexer.hpp"
+#include "Prefilter.hpp"
+#include "ReflectionDatabase.hpp"
+#include "SourceFile.hpp"
 
 /**
  * \brief designed to be ran on a visual studio project.
@@ -22,10 +35,29 @@
 
 namespace gep
 {
+	// part of the cache key, bump whenever the generated code changes
+	inline constexpr std::string_view sPreprocessorVersion = "1.6.5";
+
+	// read from the current directory
+	inline constexpr const char* sConfigName = "pconfig.json";
+
 	class Preprocessor
 	{
 	public:
 
+		// the contents of pconfig.json, paths are relative to the directory of the config
+		struct Config
+		{
+			// files with one of these extensions are preprocessed by a project scan
+			std::vector<std::string> mFileExtensions;
+
+			// searched in addition to the directory of the config
+			std::vector<std::filesystem::path> mSourcePaths;
+
+			// the .meta folder is created inside of it, empty for the current directory
+			std::filesystem::path mOutputPath;
+		};
+
 	public: // construction
 
 		// creates the preprocessor object
@@ -38,8 +70,19 @@ namespace gep
 
 	public: // step 1: startup
 
-		// reads a config if it exists
-		void ReadConfig();
+		// reads the config in the current directory and uses it, returns false if it could not be parsed
+		bool ReadConfig();
+
+		// uses config for where output goes and for project scans, call before InitializeMetaHeader
+		void SetConfig(const Config& config);
+
+		const Config& GetConfig() const;
+
+		// the folder meta files, the cache and the reflection database are written to
+		const std::filesystem::path& GetMetaPath() const;
+
+		// true once a config is in use
+		bool IsProjectMode() const;
 
 		// creates a config from a template
 		void CreateConfig() const;
@@ -48,7 +91,7 @@ namespace gep
 		bool HasConfig() const;
 
 		// will create the meta header if it doesnt exist or will, clear an existing one. make sure to do this prior to preprocessing
-		void InitializeMetaHeader() const;
+		void InitializeMetaHeader();
 
 		// generates the needed interface files
 		void GenerateIncludes() const;
@@ -56,74 +99,138 @@ namespace gep
 
 	public: // step 2: 
 
-		// returns exit code for whether a file was preprocessed correctly
-		int PreprocessFile(const std::filesystem::path& path);
+		// returns exit code for whether a file was preprocessed correctly. a dependency was found through an include
+		// so it is skipped quietly like a project scan would if it does not use reflection
+		int PreprocessFile(const std::filesystem::path& path, bool isDependency = false);
+
+		// publishes the includes and fields of a file to the include graph without generating anything, false if it could not be read
+		bool ReflectFile(const std::filesystem::path& path);
+
+		// uses the cache of other from now on so hits and stores are counted once across workers
+		void ShareCache(const Preprocessor& other);
+
+		// every file preprocessed from now on publishes its user includes and fields to graph, nullptr stops publishing
+		void SetIncludeGraph(IncludeGraph* graph);
+
+		// merges cache entries made so far into the index on disk
+		void FlushCache();
+
+		// writes the cache index and prints its hit and miss counts
+		void PrintCacheStats();
+
+		// files skipped by the prefilter and the time it saved
+		const PrefilterStats& GetPrefilterStats() const;
 
 	public:
 
-		// stores info about reflected types
+		// stores info about reflected types, every string is interned
 		struct MetaInfo
 		{
-			std::string mType;
-			std::string mVariableName;
-			std::string mParentName;
-			std::string mFullClassPath;
-			std::string mParentType;
-			std::string mKeyWord; // ie, printable, serializable...
+			StringId mType;
+			StringId mVariableName;
+			StringId mParentName;
+			StringId mFullClassPath;
+			uint32_t mFlags; // FieldFlag bits, one for every keyword in front of the declaration
+
+			// how many of the scopes around the field are namespaces, they always come before the classes
+			uint32_t mNamespaceDepth;
+
+			// the span of the declaration inside of the source file
+			uint32_t mOffset;
+			uint32_t mLength;
+		};
 
-			friend std::ostream& operator<<(std::ostream& os, const MetaInfo& info);
+		// prints a meta info with its interned strings resolved
+		std::ostream& PrintMetaInfo(std::ostream& os, const MetaInfo& info) const;
 
+	private:
+		// what happened while parsing a file
+		enum class ParseResult
+		{
+			Generated,
+			Unreflected, // an optional header does not include Reflection.hpp, it is skipped quietly
+			Failed,
 		};
 
 	private: // helpers for printing template code
 
-		void WriteFunctionDefinition(const MetaInfo& mi, const std::string& returnType, const std::string& functionPath, bool isConst);
+		// groups the collected fields by class and writes every specialization into mOutput in one forward pass
+		inline void GenerateCode();
+
+		// copies the fields of one class marked with flag into mKeywordFields, false if there are none
+		inline bool CollectKeyword(std::span<const MetaInfo> fields, uint32_t flag);
 
-		// writes a line to the internal template 
-		inline void WriteLine(const MetaInfo& mi, size_t lineNumber, const std::string& line);
+		// writes the printer specialization for one class, all fields must share a class
+		inline void BuildPrinterTemplate(std::span<const MetaInfo> fields);
 
-		// creates a template in valid cpp code, if the mi's class path has already been written too will simply add to it
-		inline void BuildPrinterTemplate(const MetaInfo& mi);
+		// gathers the serializable fields of one class and hashes them into its schema, the builders below use both
+		inline void CollectSerializable(std::span<const MetaInfo> fields);
 
-		// given meta info will create a template for serialization
-		inline void BuildSerializingTemplate(const MetaInfo& mi);
+		// writes the json reader and writer of one class, all fields must share a class
+		inline void BuildSerializingTemplate(std::span<const MetaInfo> fields);
+
+		// writes the binary codec of one class, all fields must share a class
+		inline void BuildBinaryTemplate(std::span<const MetaInfo> fields);
+
+		// specializes the zero copy gep::binary::View of one class, all fields must share a class
+		inline void BuildViewTemplate(std::span<const MetaInfo> fields);
+
+		// writes the constexpr field table of one class with every keyword in declaration order, all fields must share a class
+		inline void BuildFieldTable(std::span<const MetaInfo> fields);
 
 	private:
 		// reads the given file into a buffer
 		inline bool ReadFile(const std::filesystem::path& path);
 
-		// helper for PreprocessFile, determines if the current file has the specified include
-		inline bool HasInclude(const std::string& includedFile) const;
-
-		// replaces all user defined character strings with '$'
-		inline void MaskStrings();
+		// classifies and lexes the current file into mTokens, mTokenKinds and mIncludes
+		inline void Tokenize();
 
-		// restores all of the '$' added by MaskStrings
-		inline void RestoreStrings();
+		// classifies, lexes and collects the current file then writes its code into mOutput
+		inline ParseResult ParseAndGenerate(bool isOptional);
 
-		// removes all comments from the internal buffer
-		inline void RemoveComments();
+		// helper for PreprocessFile, determines if the current file has the specified include
+		inline bool HasInclude(const std::string& includedFile) const;
 
-		// adds padding and removes extra spaces
-		inline void NormalizeSpaces();
+		// finds a "" include next to the current file or in the project, empty if it is not on disk
+		inline std::filesystem::path ResolveInclude(std::string_view include) const;
 
-		// removes all duplicate spaces
-		inline void RemoveExtraSpaces();
+		// lexes the current file if it was not already and publishes its includes and fields to the include graph
+		inline void PublishHeader(bool mayReflect);
 
-		// adds spaces to both sides of all occurences of 'padword'
-		inline void AddPadding(std::string& fileContents, const std::string& padword) const;
+		// copies the source from first to last into result in one linear pass, comments and whitespace runs become one space
+		inline void NormalizeSpaces(Token first, Token last, std::string& result) const;
 
 		// finds the first that shows up in fileContents 
 		inline size_t FindFirstString(const std::string& fileContents, const std::vector<std::string>& strings, size_t start = 0) const;
 
-		// outputs all of the data inside of the class map to a file
-		inline void GenerateOutput() const;
+		// what happened to the meta file
+		enum class OutputResult
+		{
+			Written,
+			Unchanged, // the existing file already had the same contents, it was not touched
+			Failed,
+		};
+
+		// writes the generated code to the meta file, files that would not change are left alone so their timestamp stays put
+		inline OutputResult GenerateOutput(std::string_view code) const;
 
 		inline void CollectMetaData();
 
+		// splits the declaration between the two offsets at its commas, every declarator becomes a field that copies field
+		inline void CollectDeclarators(size_t begin, size_t end, const MetaInfo& field);
+
+		// the line of the current file an offset is on, lines start at 1
+		inline uint32_t GetLine(size_t offset) const;
+
 		// empties most member variables
 		inline void Clear();
 
+		// expands the macros a config may use and converts separators for the current platform
+		static inline std::filesystem::path ToConfigPath(std::string_view text);
+
+		// hash of the version and keyword table, mixed into every cache key
+		inline uint64_t GetConfigHash() const;
+
 		// depricates this is handled by inno
 		inline void CreateAppDataFolder() const;
 
@@ -131,17 +238,75 @@ namespace gep
 		inline std::filesystem::path GetAppDataPath() const;
 
 	private:
-		std::string mFileContents;
+		// owns the mapped or read file that mFileContents views
+		SourceFile mSourceFile;
+
+		// never modified, every token is a span inside of it
+		std::string_view mFileContents;
 
 		std::filesystem::path mFilePath;
 
-		std::vector<std::string> mTokens;
+		// picks its simd kernel once on construction
+		Classifier mClassifier;
+
+		// rules out files without any meta keyword before they are classified
+		Prefilter mPrefilter;
+
+		PrefilterStats mPrefilterStats;
+
+		// literal, comment and structural bitmasks of mFileContents
+		SourceMasks mMasks;
+
+		// views into mFileContents, only valid until the next file is read
+		std::vector<Token> mTokens;
+
+		// what each token in mTokens is, keywords are recognized by the lexer
+		std::vector<TokenKind> mTokenKinds;
+
+		// every #include of the current file, recorded by the lexer
+		std::vector<IncludeDirective> mIncludes;
+
+		// lives for the whole run so ids stay stable across files
+		Interner mInterner;
+
+		// reused when building strings that are about to be interned
+		std::string mScratch;
+
+		// every reflected field in the current file
+		std::vector<MetaInfo> mMetaInfos;
+
+		// the fields of one class in declaration order, reused for every field table
+		std::vector<const MetaInfo*> mFieldOrder;
+
+		// the fields of one class marked by the keyword being generated
+		std::vector<MetaInfo> mKeywordFields;
+
+		// declarations that could not be reflected, printed once the file is parsed
+		std::string mWarnings;
+
+		// the serializable fields of one class in declaration order, the hash of their names and types, and the buckets taken while a seed is tried
+		std::vector<std::string_view> mSerialKeys;
+		uint64_t mSerialSchema = 0;
+		std::vector<uint8_t> mBucketUsed;
+
+		// the TableView a view derives from, written twice so it is built once
+		std::string mViewTable;
+
+		// the contents of the meta file, built front to back
+		CodeWriter mOutput;
+
+		Config mConfig;
+
+		// where meta files are written, mConfig's output path followed by .meta
+		std::filesystem::path mMetaPath;
 
-		std::string mRemovedStrings;
+		// set once a config is used, every header of a project is scanned so missing reflection is not an error
+		bool mIsProjectMode;
 
-		// this is the classPath mapped to the function of that class split up into lines
-		std::map<std::string, std::list<std::string>> mClassMap;
+		// generated code of files seen by earlier runs, can be shared with other preprocessors
+		std::shared_ptr<Cache> mCache;
 
-		//std::vector<std::string> mRemovedStrings;
+		// owned by whoever follows includes, nullptr when nothing is following them
+		IncludeGraph* mIncludeGraph;
 	};
 } // namespace gep
\ No newline at end of file
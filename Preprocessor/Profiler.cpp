@@ -0,0 +1,241 @@
+/*****************************************************************//**
+ * \file   Profiler.cpp
+ * \brief
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+// std
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <OutStream.hpp>
+
+// this
+#include "Profiler.hpp"
+
+#include "Timer.hpp"
+
+namespace gep
+{
+    namespace
+    {
+        constexpr size_t sStageCount = static_cast<size_t>(Stage::Count);
+
+        // one scope as it shows up in the trace
+        struct TraceEvent
+        {
+            Stage mStage;
+            double mStart;
+            double mDuration;
+            uint64_t mBytes;
+            uint64_t mTokens;
+            std::string mDetail;
+        };
+
+        // only ever written by the thread it belongs to
+        struct ThreadProfile
+        {
+            size_t mId = 0;
+            StageStats mStages[sStageCount];
+            std::vector<TraceEvent> mEvents;
+        };
+
+        // profiles outlive their threads so workers that already exited still show up
+        std::mutex sProfilesMutex;
+        std::vector<std::unique_ptr<ThreadProfile>> sProfiles;
+
+        // every timestamp is relative to Enable
+        Timer<std::chrono::microseconds> sEpoch;
+
+        std::atomic<bool> sIsTracing = false;
+
+        ThreadProfile& GetThreadProfile()
+        {
+            // the lock is only taken the first time a thread records
+            thread_local ThreadProfile* profile = nullptr;
+
+            if (!profile)
+            {
+                std::lock_guard<std::mutex> lock(sProfilesMutex);
+                sProfiles.push_back(std::make_unique<ThreadProfile>());
+                sProfiles.back()->mId = sProfiles.size() - 1;
+                profile = sProfiles.back().get();
+            }
+
+            return *profile;
+        }
+
+        // file names are the only text that ends up in the trace
+        void WriteEscaped(std::ostream& os, std::string_view text)
+        {
+            for (const char c : text)
+            {
+                if (c == '"' || c == '\\')  os << '\\' << c;
+                else if (c == '\n')         os << "\\n";
+                else if (c == '\t')         os << "\\t";
+                else if (static_cast<unsigned char>(c) < 0x20) os << "\\u00" << "0123456789abcdef"[c >> 4] << "0123456789abcdef"[c & 0xF];
+                else                        os << c;
+            }
+        }
+    }
+
+    void Profiler::Enable(bool isTracing)
+    {
+        sEpoch.Start();
+        sIsTracing.store(isTracing, std::memory_order_relaxed);
+        sIsEnabled.store(true, std::memory_order_relaxed);
+    }
+
+    double Profiler::Now()
+    {
+        return sEpoch.Stop();
+    }
+
+    void Profiler::Record(Stage stage, double start, double duration, uint64_t bytes, uint64_t tokens, std::string_view detail)
+    {
+        ThreadProfile& profile = GetThreadProfile();
+
+        StageStats& stats = profile.mStages[static_cast<size_t>(stage)];
+        stats.mCalls++;
+        stats.mMicroseconds += duration;
+        stats.mBytes += bytes;
+        stats.mTokens += tokens;
+
+        if (sIsTracing.load(std::memory_order_relaxed))
+        {
+            profile.mEvents.push_back({ stage, start, duration, bytes, tokens, std::string(detail) });
+        }
+    }
+
+    StageTotals Profiler::GetTotals()
+    {
+        std::lock_guard<std::mutex> lock(sProfilesMutex);
+
+        StageTotals totals = {};
+        for (const std::unique_ptr<ThreadProfile>& profile : sProfiles)
+        {
+            for (size_t i = 0; i < sStageCount; i++)
+            {
+                totals[i].mCalls += profile->mStages[i].mCalls;
+                totals[i].mMicroseconds += profile->mStages[i].mMicroseconds;
+                totals[i].mBytes += profile->mStages[i].mBytes;
+                totals[i].mTokens += profile->mStages[i].mTokens;
+            }
+        }
+
+        return totals;
+    }
+
+    void Profiler::PrintSummary()
+    {
+        const StageTotals totals = GetTotals();
+
+        std::lock_guard<std::mutex> lock(sProfilesMutex);
+
+        // every share is of the time spent on whole files, summed over threads
+        const double fileMicroseconds = totals[static_cast<size_t>(Stage::File)].mMicroseconds;
+
+        gep::cout << std::left << std::setw(12) << "Stage" << std::right
+                  << std::setw(10) << "Calls" << std::setw(14) << "Total ms" << std::setw(10) << "Share"
+                  << std::setw(12) << "MB/s" << std::setw(12) << "Tokens" << std::endl;
+
+        for (size_t i = 0; i < sStageCount; i++)
+        {
+            const StageStats& stats = totals[i];
+            if (stats.mCalls == 0) continue;
+
+            const double share = fileMicroseconds > 0 ? 100.0 * stats.mMicroseconds / fileMicroseconds : 0.0;
+            const double megabytesPerSecond = stats.mMicroseconds > 0 ? stats.mBytes / stats.mMicroseconds : 0.0;
+
+            gep::cout << std::left << std::setw(12) << GetStageName(static_cast<Stage>(i)) << std::right << std::fixed << std::setprecision(3)
+                      << std::setw(10) << stats.mCalls << std::setw(14) << stats.mMicroseconds / 1000.0
+                      << std::setprecision(1) << std::setw(9) << share << '%' << std::setw(12) << megabytesPerSecond
+                      << std::setw(12) << stats.mTokens << std::defaultfloat << std::endl;
+        }
+
+        // an uneven split means the work stealing could not keep every worker busy
+        for (const std::unique_ptr<ThreadProfile>& profile : sProfiles)
+        {
+            const StageStats& files = profile->mStages[static_cast<size_t>(Stage::File)];
+            if (files.mCalls == 0) continue;
+
+            gep::cout << "Thread " << profile->mId << ": " << files.mCalls << " files in "
+                      << std::fixed << std::setprecision(3) << files.mMicroseconds / 1000.0 << std::defaultfloat << " ms" << std::endl;
+        }
+    }
+
+    void Profiler::Reset()
+    {
+        std::lock_guard<std::mutex> lock(sProfilesMutex);
+
+        // the slots stay registered, their threads still point at them
+        for (const std::unique_ptr<ThreadProfile>& profile : sProfiles)
+        {
+            for (StageStats& stats : profile->mStages) stats = StageStats();
+            profile->mEvents.clear();
+        }
+    }
+
+    bool Profiler::WriteTrace(const std::filesystem::path& path)
+    {
+        std::ofstream file(path, std::ios::binary);
+        if (!file) return false;
+
+        std::lock_guard<std::mutex> lock(sProfilesMutex);
+
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+        bool isFirst = true;
+        for (const std::unique_ptr<ThreadProfile>& profile : sProfiles)
+        {
+            // names the thread's row in the viewer, ids are given in the order threads first recorded
+            file << (isFirst ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << profile->mId
+                 << ",\"args\":{\"name\":\"thread " << profile->mId << "\"}}";
+            isFirst = false;
+
+            for (const TraceEvent& event : profile->mEvents)
+            {
+                file << ",\n{\"name\":\"" << GetStageName(event.mStage) << "\",\"cat\":\"preprocessor\",\"ph\":\"X\",\"pid\":1,\"tid\":" << profile->mId
+                     << std::fixed << std::setprecision(3) << ",\"ts\":" << event.mStart << ",\"dur\":" << event.mDuration << std::defaultfloat
+                     << ",\"args\":{\"bytes\":" << event.mBytes << ",\"tokens\":" << event.mTokens;
+
+                if (!event.mDetail.empty())
+                {
+                    file << ",\"file\":\"";
+                    WriteEscaped(file, event.mDetail);
+                    file << '"';
+                }
+
+                file << "}}";
+            }
+        }
+
+        file << "\n]}\n";
+
+        return static_cast<bool>(file.flush());
+    }
+
+    const char* Profiler::GetStageName(Stage stage)
+    {
+        switch (stage)
+        {
+        case Stage::File:      return "file";
+        case Stage::Read:      return "read";
+        case Stage::Prefilter: return "prefilter";
+        case Stage::Cache:     return "cache";
+        case Stage::Classify:  return "classify";
+        case Stage::Tokenize:  return "tokenize";
+        case Stage::Collect:   return "collect";
+        case Stage::Normalize: return "normalize";
+        case Stage::Generate:  return "generate";
+        case Stage::Output:    return "output";
+        case Stage::Publish:   return "publish";
+        default:               return "unknown";
+        }
+    }
+}
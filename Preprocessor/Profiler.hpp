@@ -0,0 +1,137 @@
+/*****************************************************************//**
+ * \file   Profiler.hpp
+ * \brief  scoped timing of every stage of preprocessing a file. each
+ *         thread aggregates into its own slot so recording never takes
+ *         a lock, disabled scopes never read the clock
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace gep
+{
+	// the stages of PreprocessFile in the order they run
+	enum class Stage : uint8_t
+	{
+		File,      // everything below for one file
+		Read,
+		Prefilter,
+		Cache,     // looking up and storing generated code
+		Classify,  // comment and literal masks, both are found in the same pass
+		Tokenize,
+		Collect,
+		Normalize, // part of collect, the type text of each field
+		Generate,
+		Output,
+		Publish,   // handing includes and fields to the include graph
+
+		Count
+	};
+
+	// totals of one stage
+	struct StageStats
+	{
+		uint64_t mCalls = 0;
+		double mMicroseconds = 0;
+		uint64_t mBytes = 0;
+		uint64_t mTokens = 0;
+	};
+
+	// the totals of every stage indexed by stage
+	using StageTotals = std::array<StageStats, static_cast<size_t>(Stage::Count)>;
+
+	class Profiler
+	{
+	public:
+		// starts recording on every thread, when tracing each scope is also kept as an event for WriteTrace
+		static void Enable(bool isTracing);
+
+		static bool IsEnabled()
+		{
+			return sIsEnabled.load(std::memory_order_relaxed);
+		}
+
+		// microseconds since Enable
+		static double Now();
+
+		// adds one finished scope to the slot of the calling thread
+		static void Record(Stage stage, double start, double duration, uint64_t bytes, uint64_t tokens, std::string_view detail);
+
+		// the totals of every stage summed across threads. call once the workers are idle
+		static StageTotals GetTotals();
+
+		// prints the totals of every stage across threads followed by the time each thread spent on files. call once the workers are idle
+		static void PrintSummary();
+
+		// forgets everything recorded so far, call once the workers are idle
+		static void Reset();
+
+		// writes every event as chrome trace_event json, open it with chrome://tracing or ui.perfetto.dev. call once the workers are idle
+		static bool WriteTrace(const std::filesystem::path& path);
+
+		static const char* GetStageName(Stage stage);
+
+	private:
+		static inline std::atomic<bool> sIsEnabled = false;
+	};
+
+	// times the stage from construction to destruction
+	class ProfileScope
+	{
+	public:
+		explicit ProfileScope(Stage stage, uint64_t bytes = 0)
+			: mStage(stage)
+			, mBytes(bytes)
+			, mTokens(0)
+			, mStart(Profiler::IsEnabled() ? Profiler::Now() : -1.0)
+		{
+		}
+
+		~ProfileScope()
+		{
+			if (mStart >= 0) Profiler::Record(mStage, mStart, Profiler::Now() - mStart, mBytes, mTokens, mDetail);
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+		// for work that is only known once the stage is running
+		void AddBytes(uint64_t bytes)
+		{
+			mBytes += bytes;
+		}
+
+		void AddTokens(uint64_t tokens)
+		{
+			mTokens += tokens;
+		}
+
+		// shown on the event in the trace ie the file name
+		void SetDetail(std::string_view detail)
+		{
+			if (mStart >= 0) mDetail = detail;
+		}
+
+	private:
+		Stage mStage;
+
+		uint64_t mBytes;
+
+		uint64_t mTokens;
+
+		// negative when the profiler was disabled
+		double mStart;
+
+		std::string mDetail;
+	};
+} // namespace gep
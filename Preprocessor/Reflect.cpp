@@ -0,0 +1,424 @@
+/*****************************************************************//**
+ * \file   Reflect.cpp
+ * \brief
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+// std
+#include <bit>
+#include <string>
+
+// this
+#include "Reflect.hpp"
+
+namespace gep
+{
+    namespace
+    {
+        // counting sort of every row into the slot it belongs to, keeping the rows of each slot in order
+        template<typename Handle, typename GetSlot>
+        void Group(const preprocessor* owner, uint32_t rowCount, uint32_t slotCount, GetSlot&& getSlot, std::vector<Handle>& grouped, std::vector<uint32_t>& offsets)
+        {
+            offsets.assign(slotCount + 1, 0);
+            for (uint32_t row = 0; row < rowCount; row++) offsets[getSlot(row) + 1]++;
+            for (uint32_t slot = 0; slot < slotCount; slot++) offsets[slot + 1] += offsets[slot];
+
+            std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+
+            grouped.assign(rowCount, Handle());
+            for (uint32_t row = 0; row < rowCount; row++) grouped[next[getSlot(row)]++] = Handle(owner, row);
+        }
+
+        // the handles of one slot
+        template<typename Handle>
+        std::span<const Handle> GetGroup(const std::vector<Handle>& grouped, const std::vector<uint32_t>& offsets, uint32_t slot)
+        {
+            if (slot + 1 >= offsets.size()) return std::span<const Handle>();
+
+            return std::span<const Handle>(grouped.data() + offsets[slot], offsets[slot + 1] - offsets[slot]);
+        }
+    }
+
+    namespace reflect
+    {
+        variable::variable(const preprocessor* owner, uint32_t index)
+            : mOwner(owner)
+            , mIndex(index)
+        {
+        }
+
+        std::string_view variable::get_name() const
+        {
+            return is_valid() ? mOwner->mDatabase.GetString(mOwner->Get(Column::FieldNames, mIndex)) : std::string_view();
+        }
+
+        std::string_view variable::get_type() const
+        {
+            return is_valid() ? mOwner->mDatabase.GetString(mOwner->Get(Column::FieldTypes, mIndex)) : std::string_view();
+        }
+
+        bool variable::is_const() const
+        {
+            const std::string_view type = get_type();
+
+            // east const applies to whatever is left of it, including a pointer
+            if (type.ends_with(" const") || type.ends_with("*const") || type.ends_with("&const")) return true;
+
+            // west const only applies to the variable when nothing points at it
+            return type.starts_with("const ") && type.find_first_of("*&") == std::string_view::npos;
+        }
+
+        bool variable::is_printable() const
+        {
+            return is_valid() && (mOwner->Get(Column::FieldFlags, mIndex) & FieldPrintable);
+        }
+
+        bool variable::is_serializable() const
+        {
+            return is_valid() && (mOwner->Get(Column::FieldFlags, mIndex) & FieldSerializable);
+        }
+
+        std::string_view variable::get_file() const
+        {
+            return get_class().get_file();
+        }
+
+        uint32_t variable::get_line() const
+        {
+            return is_valid() ? mOwner->Get(Column::FieldLines, mIndex) : 0;
+        }
+
+        rclass variable::get_class() const
+        {
+            return is_valid() ? rclass(mOwner, mOwner->Get(Column::FieldClasses, mIndex)) : rclass();
+        }
+
+        bool variable::is_valid() const
+        {
+            return mOwner && mIndex < mOwner->mVariables.size();
+        }
+
+        std::string_view function::get_name() const
+        {
+            return std::string_view();
+        }
+
+        std::span<const variable> function::get_arguments() const
+        {
+            return std::span<const variable>();
+        }
+
+        rclass::rclass(const preprocessor* owner, uint32_t index)
+            : mOwner(owner)
+            , mIndex(index)
+        {
+        }
+
+        std::string_view rclass::get_name() const
+        {
+            return is_valid() ? mOwner->mDatabase.GetString(mOwner->Get(Column::ClassNames, mIndex)) : std::string_view();
+        }
+
+        std::string_view rclass::get_path() const
+        {
+            return is_valid() ? mOwner->mDatabase.GetString(mOwner->Get(Column::ClassPaths, mIndex)) : std::string_view();
+        }
+
+        std::string_view rclass::get_file() const
+        {
+            if (!is_valid()) return std::string_view();
+
+            return mOwner->mDatabase.GetString(mOwner->Get(Column::FilePaths, mOwner->Get(Column::ClassFiles, mIndex)));
+        }
+
+        rnamespace rclass::get_namespace() const
+        {
+            return is_valid() ? rnamespace(mOwner, mOwner->Get(Column::ClassNamespaces, mIndex)) : rnamespace();
+        }
+
+        rclass rclass::get_outer() const
+        {
+            const uint32_t outer = is_valid() ? mOwner->Get(Column::ClassOuters, mIndex) : sNoIndex;
+            return (outer == sNoIndex) ? rclass() : rclass(mOwner, outer);
+        }
+
+        std::span<const variable> rclass::get_variables() const
+        {
+            if (!is_valid()) return std::span<const variable>();
+
+            return std::span<const variable>(mOwner->mVariables).subspan(mOwner->Get(Column::ClassFirstFields, mIndex), mOwner->Get(Column::ClassFieldCounts, mIndex));
+        }
+
+        variable rclass::get_variable(std::string_view name) const
+        {
+            if (!is_valid()) return variable();
+
+            const ReflectionDatabase& database = mOwner->mDatabase;
+            const uint32_t row = mOwner->mVariableNames.Find(preprocessor::GetNameHash(mIndex, name), [&](uint32_t row)
+                {
+                    return mOwner->Get(Column::FieldClasses, row) == mIndex && database.GetString(mOwner->Get(Column::FieldNames, row)) == name;
+                });
+
+            return (row == sNoIndex) ? variable() : variable(mOwner, row);
+        }
+
+        std::span<const rclass> rclass::get_classes() const
+        {
+            if (!is_valid()) return std::span<const rclass>();
+
+            return GetGroup(mOwner->mScopeClasses, mOwner->mScopeClassOffsets, mOwner->GetClassSlot(mIndex));
+        }
+
+        rclass rclass::get_class(std::string_view name) const
+        {
+            if (!is_valid()) return rclass();
+
+            // a path is resolved against the path of this class
+            if (name.find("::") != std::string_view::npos)
+            {
+                return mOwner->get_class(std::string(get_path()).append("::").append(name));
+            }
+
+            const uint32_t slot = mOwner->GetClassSlot(mIndex);
+            const uint32_t row = mOwner->mClassNames.Find(preprocessor::GetNameHash(slot, name), [&](uint32_t row)
+                {
+                    return mOwner->Get(Column::ClassOuters, row) == mIndex && mOwner->mDatabase.GetString(mOwner->Get(Column::ClassNames, row)) == name;
+                });
+
+            return (row == sNoIndex) ? rclass() : rclass(mOwner, row);
+        }
+
+        std::span<const function> rclass::get_functions() const
+        {
+            return std::span<const function>();
+        }
+
+        bool rclass::is_valid() const
+        {
+            return mOwner && mIndex < mOwner->mClasses.size();
+        }
+
+        rnamespace::rnamespace(const preprocessor* owner, uint32_t index)
+            : mOwner(owner)
+            , mIndex(index)
+            , mIsValid(owner && (index == sNoIndex || index < owner->mDatabase.GetNamespaceCount()))
+        {
+        }
+
+        std::string_view rnamespace::get_name() const
+        {
+            if (!is_valid() || is_global()) return std::string_view();
+
+            return mOwner->mDatabase.GetString(mOwner->Get(Column::NamespaceNames, mIndex));
+        }
+
+        std::string_view rnamespace::get_path() const
+        {
+            if (!is_valid() || is_global()) return std::string_view();
+
+            return mOwner->mDatabase.GetString(mOwner->Get(Column::NamespacePaths, mIndex));
+        }
+
+        rnamespace rnamespace::get_parent() const
+        {
+            if (!is_valid() || is_global()) return rnamespace();
+
+            return rnamespace(mOwner, mOwner->Get(Column::NamespaceParents, mIndex));
+        }
+
+        std::span<const rnamespace> rnamespace::get_namespaces() const
+        {
+            if (!is_valid()) return std::span<const rnamespace>();
+
+            return GetGroup(mOwner->mScopeNamespaces, mOwner->mScopeNamespaceOffsets, mOwner->GetNamespaceSlot(mIndex));
+        }
+
+        rnamespace rnamespace::get_namespace(std::string_view name) const
+        {
+            if (!is_valid()) return rnamespace();
+
+            const uint32_t slot = mOwner->GetNamespaceSlot(mIndex);
+            const uint32_t row = mOwner->mNamespaceNames.Find(preprocessor::GetNameHash(slot, name), [&](uint32_t row)
+                {
+                    return mOwner->Get(Column::NamespaceParents, row) == mIndex && mOwner->mDatabase.GetString(mOwner->Get(Column::NamespaceNames, row)) == name;
+                });
+
+            return (row == sNoIndex) ? rnamespace() : rnamespace(mOwner, row);
+        }
+
+        std::span<const rclass> rnamespace::get_classes() const
+        {
+            if (!is_valid()) return std::span<const rclass>();
+
+            return GetGroup(mOwner->mScopeClasses, mOwner->mScopeClassOffsets, mOwner->GetNamespaceSlot(mIndex));
+        }
+
+        rclass rnamespace::get_class(std::string_view name) const
+        {
+            if (!is_valid()) return rclass();
+
+            if (name.find("::") != std::string_view::npos)
+            {
+                return is_global() ? mOwner->get_class(name) : mOwner->get_class(std::string(get_path()).append("::").append(name));
+            }
+
+            const uint32_t slot = mOwner->GetNamespaceSlot(mIndex);
+            const uint32_t row = mOwner->mClassNames.Find(preprocessor::GetNameHash(slot, name), [&](uint32_t row)
+                {
+                    return mOwner->Get(Column::ClassOuters, row) == sNoIndex
+                        && mOwner->Get(Column::ClassNamespaces, row) == mIndex
+                        && mOwner->mDatabase.GetString(mOwner->Get(Column::ClassNames, row)) == name;
+                });
+
+            return (row == sNoIndex) ? rclass() : rclass(mOwner, row);
+        }
+
+        bool rnamespace::is_global() const
+        {
+            return mIsValid && mIndex == sNoIndex;
+        }
+
+        bool rnamespace::is_valid() const
+        {
+            return mIsValid;
+        }
+    }
+
+    void preprocessor::NameIndex::Reset(size_t count)
+    {
+        // at most half full so probes stay short
+        const size_t capacity = std::bit_ceil(count * 2 + 1);
+
+        mHashes.assign(capacity, 0);
+        mRows.assign(capacity, sNoIndex);
+    }
+
+    void preprocessor::NameIndex::Insert(uint64_t hash, uint32_t row)
+    {
+        const size_t mask = mRows.size() - 1;
+
+        size_t slot = hash & mask;
+        while (mRows[slot] != sNoIndex) slot = (slot + 1) & mask;
+
+        mHashes[slot] = hash;
+        mRows[slot] = row;
+    }
+
+    preprocessor::preprocessor()
+    {
+        // every header loaded publishes what it found
+        mPreprocessor.SetIncludeGraph(&mIncludeGraph);
+    }
+
+    bool preprocessor::load(const std::filesystem::path& path)
+    {
+        // the database already holds every table, only the handles and indexes are built
+        if (path.extension() == ".db")
+        {
+            mIncludeGraph.Clear();
+
+            const bool isOpen = mDatabase.Open(path);
+            BuildIndexes();
+
+            return isOpen;
+        }
+
+        // loaded before, along with everything it includes
+        HeaderInfo info;
+        if (!mIncludeGraph.Claim(path)) return mIncludeGraph.Find(path, info);
+
+        if (!mPreprocessor.ReflectFile(path)) return false;
+
+        // user includes are loaded in the order they are found, each one once
+        std::vector<std::filesystem::path> pending{ path };
+        for (size_t next = 0; next < pending.size(); next++)
+        {
+            if (next && !mPreprocessor.ReflectFile(pending[next])) continue;
+            if (!mIncludeGraph.Find(pending[next], info)) continue;
+
+            for (const std::filesystem::path& include : info.mIncludes)
+            {
+                if (mIncludeGraph.Claim(include)) pending.push_back(include);
+            }
+        }
+
+        const bool isLoaded = mDatabase.Load(ReflectionDatabase::Build(mIncludeGraph));
+        BuildIndexes();
+
+        return isLoaded;
+    }
+
+    reflect::rnamespace preprocessor::get_global_namespace() const
+    {
+        return reflect::rnamespace(this, sNoIndex);
+    }
+
+    std::span<const reflect::rclass> preprocessor::get_classes() const
+    {
+        return mClasses;
+    }
+
+    reflect::rclass preprocessor::get_class(std::string_view path) const
+    {
+        const uint32_t row = mDatabase.FindClass(path);
+        return (row == sNoIndex) ? reflect::rclass() : reflect::rclass(this, row);
+    }
+
+    uint32_t preprocessor::GetNamespaceSlot(uint32_t namespaceIndex) const
+    {
+        const uint32_t namespaceCount = static_cast<uint32_t>(mDatabase.GetNamespaceCount());
+        return (namespaceIndex == sNoIndex) ? namespaceCount : namespaceIndex;
+    }
+
+    uint32_t preprocessor::GetClassSlot(uint32_t classIndex) const
+    {
+        return static_cast<uint32_t>(mDatabase.GetNamespaceCount()) + 1 + classIndex;
+    }
+
+    void preprocessor::BuildIndexes()
+    {
+        const uint32_t namespaceCount = static_cast<uint32_t>(mDatabase.GetNamespaceCount());
+        const uint32_t classCount = static_cast<uint32_t>(mDatabase.GetClassCount());
+        const uint32_t fieldCount = static_cast<uint32_t>(mDatabase.GetFieldCount());
+
+        mVariables.clear();
+        mVariables.reserve(fieldCount);
+        for (uint32_t row = 0; row < fieldCount; row++) mVariables.emplace_back(this, row);
+
+        mClasses.clear();
+        mClasses.reserve(classCount);
+        for (uint32_t row = 0; row < classCount; row++) mClasses.emplace_back(this, row);
+
+        // a class is declared in its outer class if it has one, otherwise in its namespace
+        const auto getClassScope = [this](uint32_t row)
+            {
+                const uint32_t outer = Get(Column::ClassOuters, row);
+                return (outer != sNoIndex) ? GetClassSlot(outer) : GetNamespaceSlot(Get(Column::ClassNamespaces, row));
+            };
+
+        const auto getNamespaceScope = [this](uint32_t row) { return GetNamespaceSlot(Get(Column::NamespaceParents, row)); };
+
+        Group(this, classCount, namespaceCount + 1 + classCount, getClassScope, mScopeClasses, mScopeClassOffsets);
+        Group(this, namespaceCount, namespaceCount + 1, getNamespaceScope, mScopeNamespaces, mScopeNamespaceOffsets);
+
+        mClassNames.Reset(classCount);
+        for (uint32_t row = 0; row < classCount; row++)
+        {
+            mClassNames.Insert(GetNameHash(getClassScope(row), mDatabase.GetString(Get(Column::ClassNames, row))), row);
+        }
+
+        mVariableNames.Reset(fieldCount);
+        for (uint32_t row = 0; row < fieldCount; row++)
+        {
+            mVariableNames.Insert(GetNameHash(Get(Column::FieldClasses, row), mDatabase.GetString(Get(Column::FieldNames, row))), row);
+        }
+
+        mNamespaceNames.Reset(namespaceCount);
+        for (uint32_t row = 0; row < namespaceCount; row++)
+        {
+            mNamespaceNames.Insert(GetNameHash(getNamespaceScope(row), mDatabase.GetString(Get(Column::NamespaceNames, row))), row);
+        }
+    }
+}
@@ -0,0 +1,249 @@
+/*****************************************************************//**
+ * \file   Reflect.hpp
+ * \brief  library interface for writing custom preprocessors. every
+ *         handle is an index into flat tables shared by the whole
+ *         project, so queries never chase pointers and names are found
+ *         through hashed indexes
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// preprocessor
+#include "Hash.hpp"
+#include "IncludeGraph.hpp"
+#include "Preprocessor.hpp"
+#include "ReflectionDatabase.hpp"
+
+namespace gep
+{
+	class preprocessor;
+
+	namespace reflect
+	{
+		class rclass;
+		class rnamespace;
+
+		// a reflected field of a class
+		class variable
+		{
+		public:
+			variable() = default;
+			variable(const preprocessor* owner, uint32_t index);
+
+			std::string_view get_name() const;
+
+			// the declared type with its spacing normalized
+			std::string_view get_type() const;
+
+			// true if the variable itself is const, a pointer to const is not
+			bool is_const() const;
+
+			bool is_printable() const;
+			bool is_serializable() const;
+
+			// the header it is declared in and the line of the declaration, starting at 1
+			std::string_view get_file() const;
+			uint32_t get_line() const;
+
+			rclass get_class() const;
+
+			// false for the result of a lookup that found nothing
+			bool is_valid() const;
+			explicit operator bool() const { return is_valid(); }
+
+		private:
+			const preprocessor* mOwner = nullptr;
+			uint32_t mIndex = sNoIndex;
+		};
+
+		// functions are not collected by the parser yet, so every class has none
+		class function
+		{
+		public:
+			std::string_view get_name() const;
+
+			std::span<const variable> get_arguments() const;
+		};
+
+		class rclass
+		{
+		public:
+			rclass() = default;
+			rclass(const preprocessor* owner, uint32_t index);
+
+			std::string_view get_name() const;
+
+			// the name with every namespace and outer class, ie game::Player::Stats
+			std::string_view get_path() const;
+
+			// the header the class was first seen in
+			std::string_view get_file() const;
+
+			// the innermost namespace around the class, global if there is none
+			rnamespace get_namespace() const;
+
+			// the class this one is nested in, invalid if it is not nested
+			rclass get_outer() const;
+
+			// every reflected field in declaration order
+			std::span<const variable> get_variables() const;
+			variable get_variable(std::string_view name) const;
+
+			// classes nested directly inside of this one
+			std::span<const rclass> get_classes() const;
+			rclass get_class(std::string_view name) const;
+
+			std::span<const function> get_functions() const;
+
+			bool is_valid() const;
+			explicit operator bool() const { return is_valid(); }
+
+		private:
+			const preprocessor* mOwner = nullptr;
+			uint32_t mIndex = sNoIndex;
+		};
+
+		class rnamespace
+		{
+		public:
+			rnamespace() = default;
+
+			// sNoIndex is the global namespace
+			rnamespace(const preprocessor* owner, uint32_t index);
+
+			// both are empty for the global namespace
+			std::string_view get_name() const;
+			std::string_view get_path() const;
+
+			// the namespace around this one, global for a namespace at global scope
+			rnamespace get_parent() const;
+
+			// namespaces declared directly inside of this one
+			std::span<const rnamespace> get_namespaces() const;
+			rnamespace get_namespace(std::string_view name) const;
+
+			// classes declared directly inside of this one, nested classes belong to their outer class
+			std::span<const rclass> get_classes() const;
+
+			// a name with :: in it is looked up as a path relative to this namespace
+			rclass get_class(std::string_view name) const;
+
+			bool is_global() const;
+
+			bool is_valid() const;
+			explicit operator bool() const { return is_valid(); }
+
+		private:
+			const preprocessor* mOwner = nullptr;
+			uint32_t mIndex = sNoIndex;
+			bool mIsValid = false;
+		};
+	} // namespace reflect
+
+	class preprocessor
+	{
+	public:
+		preprocessor();
+
+		preprocessor(const preprocessor&) = delete;
+		preprocessor& operator=(const preprocessor&) = delete;
+
+		// loads a header and every user header it includes, each header is read once no matter how often it is loaded.
+		// a database written by -database is mapped as it is instead, and replaces everything loaded before it
+		bool load(const std::filesystem::path& path);
+
+		reflect::rnamespace get_global_namespace() const;
+
+		// every class of every namespace sorted by path
+		std::span<const reflect::rclass> get_classes() const;
+
+		// looks a class up by its full path, ie game::Player
+		reflect::rclass get_class(std::string_view path) const;
+
+	private:
+		friend class reflect::variable;
+		friend class reflect::rclass;
+		friend class reflect::rnamespace;
+
+		// open addressing from a name and the scope it is declared in to a row of a table
+		class NameIndex
+		{
+		public:
+			// empties the index and makes room for count rows
+			void Reset(size_t count);
+
+			void Insert(uint64_t hash, uint32_t row);
+
+			// the first row with hash that matches, sNoIndex if there is none
+			template<typename Matches>
+			uint32_t Find(uint64_t hash, Matches&& matches) const
+			{
+				if (mRows.empty()) return sNoIndex;
+
+				const size_t mask = mRows.size() - 1;
+				for (size_t slot = hash & mask;; slot = (slot + 1) & mask)
+				{
+					if (mRows[slot] == sNoIndex) return sNoIndex;
+					if (mHashes[slot] == hash && matches(mRows[slot])) return mRows[slot];
+				}
+			}
+
+		private:
+			std::vector<uint64_t> mHashes;
+			std::vector<uint32_t> mRows;
+		};
+
+		// a row of a uint32_t column
+		uint32_t Get(Column column, uint32_t row) const
+		{
+			return mDatabase.GetColumn<uint32_t>(column)[row];
+		}
+
+		// the scope a name is hashed with, namespaces come first then the global namespace then classes
+		uint32_t GetNamespaceSlot(uint32_t namespaceIndex) const;
+		uint32_t GetClassSlot(uint32_t classIndex) const;
+
+		// the key of a name inside of the scope with slot
+		static uint64_t GetNameHash(uint32_t slot, std::string_view name)
+		{
+			return Hash64(name, slot);
+		}
+
+		// rebuilds the handles, the groups and the name indexes after the database changed
+		void BuildIndexes();
+
+	private:
+		// parses headers for load
+		Preprocessor mPreprocessor;
+
+		// every header loaded so far
+		IncludeGraph mIncludeGraph;
+
+		// the tables every handle points into
+		ReflectionDatabase mDatabase;
+
+		// one handle per row, so the fields of a class are a subspan
+		std::vector<reflect::variable> mVariables;
+		std::vector<reflect::rclass> mClasses;
+
+		// classes and namespaces grouped by the slot of the scope they are declared in, offsets has one more entry than there are slots
+		std::vector<reflect::rclass> mScopeClasses;
+		std::vector<uint32_t> mScopeClassOffsets;
+		std::vector<reflect::rnamespace> mScopeNamespaces;
+		std::vector<uint32_t> mScopeNamespaceOffsets;
+
+		NameIndex mClassNames;
+		NameIndex mVariableNames;
+		NameIndex mNamespaceNames;
+	};
+} // namespace gep
@@ -9,15 +9,18 @@
 
 #pragma once
 
+#include <Fields.hpp>
 #include <Serializing.hpp>
+#include <Binary.hpp>
+#include <View.hpp>
 #include <Printing.hpp>
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// used prior to a variable declaration: serializable int Value;
 /// enables the variable to be serialized using either read or write in a gep::json::file
-#define serializable friend class gep::json::File;
+#define serializable friend class gep::json::File; template<typename gep_detail_reader_type> friend struct gep::json::Reader; template<typename gep_detail_writer_type> friend struct gep::json::Writer; template<typename gep_detail_codec_type> friend struct gep::binary::Codec; template<typename gep_detail_view_type> friend struct gep::binary::View; template<typename gep_detail_fields_type> friend struct gep::detail::Fields;
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// used prior to a variable declaration: serializable int Value;
 /// enables the variable to be printed when using gep::print(...);
-#define printable template<typename gep_detail_printer_type, typename gep_detail_void> friend struct gep::detail::Printer;
\ No newline at end of file
+#define printable template<typename gep_detail_printer_type, typename gep_detail_void> friend struct gep::detail::Printer; template<typename gep_detail_fields_type> friend struct gep::detail::Fields;
\ No newline at end of file
@@ -0,0 +1,429 @@
+/*****************************************************************//**
+ * \file   ReflectionDatabase.cpp
+ * \brief
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+// std
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// this
+#include "ReflectionDatabase.hpp"
+
+#include "IncludeGraph.hpp"
+
+namespace gep
+{
+    namespace
+    {
+        constexpr char sMagic[4] = { 'G', 'E', 'P', 'R' };
+
+        // each distinct string is stored once no matter how many records use it
+        class StringTable
+        {
+        public:
+            StringTable()
+            {
+                mOffsets.push_back(0);
+            }
+
+            uint32_t Add(std::string_view string)
+            {
+                const auto found = mIds.find(std::string(string));
+                if (found != mIds.end()) return found->second;
+
+                const uint32_t id = static_cast<uint32_t>(mOffsets.size() - 1);
+                mIds.emplace(string, id);
+
+                mData.append(string).push_back('\0');
+                mOffsets.push_back(static_cast<uint32_t>(mData.size()));
+
+                return id;
+            }
+
+            std::vector<uint32_t> mOffsets;
+            std::string mData;
+
+        private:
+            std::unordered_map<std::string, uint32_t> mIds;
+        };
+
+        struct FieldBuild
+        {
+            uint32_t mName;
+            uint32_t mType;
+            uint32_t mFlags;
+            uint32_t mFile;
+            uint32_t mLine;
+            uint32_t mOffset;
+            uint32_t mLength;
+        };
+
+        struct ClassBuild
+        {
+            uint32_t mIndex;
+            uint32_t mName;
+            uint32_t mFile;
+            std::string mNamespace; // empty at global scope
+            std::string mOuter;     // empty when not nested
+            std::vector<FieldBuild> mFields;
+        };
+
+        struct NamespaceBuild
+        {
+            uint32_t mIndex;
+            uint32_t mName;
+            std::string mParent;
+        };
+
+        // the index of key in a sorted map once every entry has its mIndex
+        template<typename Map>
+        uint32_t IndexOf(const Map& map, const std::string& key)
+        {
+            if (key.empty()) return sNoIndex;
+
+            const auto found = map.find(key);
+            return (found == map.end()) ? sNoIndex : found->second.mIndex;
+        }
+    }
+
+    ReflectionDatabase::ReflectionDatabase()
+        : mColumns()
+        , mIsOpen(false)
+    {
+    }
+
+    std::string ReflectionDatabase::Build(const IncludeGraph& graph)
+    {
+        StringTable strings;
+        std::vector<uint32_t> files;
+
+        // std::map keeps both tables sorted by path so readers can binary search them
+        std::map<std::string, NamespaceBuild> namespaces;
+        std::map<std::string, ClassBuild> classes;
+
+        HeaderInfo info;
+        std::vector<size_t> ends;
+
+        for (const std::filesystem::path& header : graph.GetHeaders())
+        {
+            if (!graph.Find(header, info) || info.mFields.empty()) continue;
+
+            const uint32_t file = static_cast<uint32_t>(files.size());
+            files.push_back(strings.Add(header.string()));
+
+            for (const ReflectedField& field : info.mFields)
+            {
+                const std::string& classPath = field.mClassPath;
+
+                // where each scope of the path ends, the last one is the class itself
+                ends.clear();
+                for (size_t separator = classPath.find("::"); separator != std::string::npos; separator = classPath.find("::", separator + 2))
+                {
+                    ends.push_back(separator);
+                }
+                ends.push_back(classPath.size());
+
+                // a keyword directly inside of a namespace has no class to belong to
+                if (field.mNamespaceDepth >= ends.size()) continue;
+
+                for (size_t scope = 0; scope < ends.size(); scope++)
+                {
+                    const size_t begin = scope ? ends[scope - 1] + 2 : 0;
+                    const std::string_view name = std::string_view(classPath).substr(begin, ends[scope] - begin);
+
+                    const std::string parent = scope ? classPath.substr(0, ends[scope - 1]) : std::string();
+                    std::string scopePath = classPath.substr(0, ends[scope]);
+
+                    if (scope < field.mNamespaceDepth)
+                    {
+                        namespaces.try_emplace(std::move(scopePath), NamespaceBuild{ 0, strings.Add(name), parent });
+                        continue;
+                    }
+
+                    // outer classes are recorded even when they reflect nothing themselves
+                    const std::string nameSpace = field.mNamespaceDepth ? classPath.substr(0, ends[field.mNamespaceDepth - 1]) : std::string();
+                    const std::string outer = (scope > field.mNamespaceDepth) ? parent : std::string();
+
+                    classes.try_emplace(std::move(scopePath), ClassBuild{ 0, strings.Add(name), file, nameSpace, outer, {} });
+                }
+
+                classes[classPath].mFields.push_back({ strings.Add(field.mName), strings.Add(field.mType), field.mFlags,
+                                                       file, field.mLine, field.mOffset, field.mLength });
+            }
+        }
+
+        // indexes follow the sorted order
+        uint32_t index = 0;
+        for (auto& [namespacePath, build] : namespaces) build.mIndex = index++;
+
+        index = 0;
+        for (auto& [classPath, build] : classes) build.mIndex = index++;
+
+        std::array<std::vector<uint32_t>, static_cast<size_t>(Column::Count)> columns;
+        const auto column = [&columns](Column id) -> std::vector<uint32_t>& { return columns[static_cast<size_t>(id)]; };
+
+        column(Column::FilePaths) = std::move(files);
+
+        for (const auto& [namespacePath, build] : namespaces)
+        {
+            column(Column::NamespaceNames).push_back(build.mName);
+            column(Column::NamespacePaths).push_back(strings.Add(namespacePath));
+            column(Column::NamespaceParents).push_back(IndexOf(namespaces, build.mParent));
+        }
+
+        for (auto& [classPath, build] : classes)
+        {
+            column(Column::ClassNames).push_back(build.mName);
+            column(Column::ClassPaths).push_back(strings.Add(classPath));
+            column(Column::ClassNamespaces).push_back(IndexOf(namespaces, build.mNamespace));
+            column(Column::ClassOuters).push_back(IndexOf(classes, build.mOuter));
+            column(Column::ClassFiles).push_back(build.mFile);
+
+            // declaration order, printable and serializable were generated as separate groups
+            std::stable_sort(build.mFields.begin(), build.mFields.end(), [](const FieldBuild& a, const FieldBuild& b)
+                {
+                    return (a.mFile != b.mFile) ? a.mFile < b.mFile : a.mOffset < b.mOffset;
+                });
+
+            const size_t firstField = column(Column::FieldNames).size();
+
+            for (const FieldBuild& field : build.mFields)
+            {
+                // a field marked by both keywords is one field with both flags
+                const std::vector<uint32_t>& names = column(Column::FieldNames);
+                const auto same = std::find(names.begin() + firstField, names.end(), field.mName);
+                if (same != names.end())
+                {
+                    column(Column::FieldFlags)[same - names.begin()] |= field.mFlags;
+                    continue;
+                }
+
+                column(Column::FieldNames).push_back(field.mName);
+                column(Column::FieldTypes).push_back(field.mType);
+                column(Column::FieldClasses).push_back(build.mIndex);
+                column(Column::FieldFlags).push_back(field.mFlags);
+                column(Column::FieldLines).push_back(field.mLine);
+                column(Column::FieldOffsets).push_back(field.mOffset);
+                column(Column::FieldLengths).push_back(field.mLength);
+            }
+
+            column(Column::ClassFirstFields).push_back(static_cast<uint32_t>(firstField));
+            column(Column::ClassFieldCounts).push_back(static_cast<uint32_t>(column(Column::FieldNames).size() - firstField));
+        }
+
+        // every string is added by now
+        column(Column::StringOffsets) = std::move(strings.mOffsets);
+
+        // header, column entries, then every column 8 byte aligned
+        std::array<ColumnEntry, static_cast<size_t>(Column::Count)> entries = {};
+        uint64_t size = sizeof(Header) + sizeof(entries);
+
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            const bool isChars = static_cast<Column>(i) == Column::StringData;
+
+            entries[i].mElementSize = isChars ? sizeof(char) : sizeof(uint32_t);
+            entries[i].mCount = isChars ? strings.mData.size() : columns[i].size();
+            entries[i].mOffset = (size + 7) & ~uint64_t(7);
+
+            size = entries[i].mOffset + entries[i].mCount * entries[i].mElementSize;
+        }
+
+        Header header = {};
+        std::memcpy(header.mMagic, sMagic, sizeof(sMagic));
+        header.mVersion = sVersion;
+        header.mColumnCount = static_cast<uint32_t>(entries.size());
+        header.mSize = size;
+
+        std::string data(static_cast<size_t>(size), '\0');
+        std::memcpy(data.data(), &header, sizeof(header));
+        std::memcpy(data.data() + sizeof(header), entries.data(), sizeof(entries));
+
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            const void* source = (static_cast<Column>(i) == Column::StringData) ? static_cast<const void*>(strings.mData.data()) : columns[i].data();
+            if (entries[i].mCount) std::memcpy(data.data() + entries[i].mOffset, source, static_cast<size_t>(entries[i].mCount * entries[i].mElementSize));
+        }
+
+        return data;
+    }
+
+    bool ReflectionDatabase::Write(const std::filesystem::path& path, const IncludeGraph& graph)
+    {
+        const std::string data = Build(graph);
+
+        // written next to the real file then renamed over it, a reader still holding the old mapping keeps its copy
+        std::filesystem::path tempPath = path;
+        tempPath += ".tmp";
+
+        {
+            std::ofstream file(tempPath, std::ios::binary);
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!file.flush()) return false;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, path, error);
+        if (error)
+        {
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool ReflectionDatabase::Open(const std::filesystem::path& path)
+    {
+        Close();
+
+        if (!mFile.Open(path)) return false;
+
+        mView = mFile.View();
+        if (!Validate())
+        {
+            Close();
+            return false;
+        }
+
+        mIsOpen = true;
+        return true;
+    }
+
+    bool ReflectionDatabase::Load(std::string data)
+    {
+        Close();
+
+        // a std::string is at least 8 byte aligned on the heap, which every column relies on
+        mBuffer = std::move(data);
+        mView = mBuffer;
+        if (!Validate())
+        {
+            Close();
+            return false;
+        }
+
+        mIsOpen = true;
+        return true;
+    }
+
+    void ReflectionDatabase::Close()
+    {
+        mFile.Close();
+        mBuffer.clear();
+        mView = std::string_view();
+        mColumns = {};
+        mIsOpen = false;
+    }
+
+    inline bool ReflectionDatabase::Validate()
+    {
+        const std::string_view view = mView;
+
+        Header header = {};
+        if (view.size() < sizeof(header) + sizeof(mColumns)) return false;
+
+        std::memcpy(&header, view.data(), sizeof(header));
+        std::memcpy(mColumns.data(), view.data() + sizeof(header), sizeof(mColumns));
+
+        bool isValid = std::memcmp(header.mMagic, sMagic, sizeof(sMagic)) == 0
+                    && header.mVersion == sVersion
+                    && header.mColumnCount == mColumns.size()
+                    && header.mSize == view.size();
+
+        // only the bounds are checked, the contents are trusted just like a mapped cache index
+        for (size_t i = 0; isValid && i < mColumns.size(); i++)
+        {
+            const ColumnEntry& entry = mColumns[i];
+            const uint32_t elementSize = (static_cast<Column>(i) == Column::StringData) ? sizeof(char) : sizeof(uint32_t);
+
+            isValid = entry.mElementSize == elementSize
+                   && entry.mOffset % 8 == 0
+                   && entry.mOffset <= view.size()
+                   && entry.mCount <= (view.size() - entry.mOffset) / elementSize;
+        }
+
+        // the columns of a table have to agree on its length
+        const auto sameLength = [this](Column first, Column last)
+            {
+                for (size_t i = static_cast<size_t>(first); i <= static_cast<size_t>(last); i++)
+                {
+                    if (mColumns[i].mCount != mColumns[static_cast<size_t>(first)].mCount) return false;
+                }
+                return true;
+            };
+
+        isValid = isValid
+               && sameLength(Column::NamespaceNames, Column::NamespaceParents)
+               && sameLength(Column::ClassNames, Column::ClassFieldCounts)
+               && sameLength(Column::FieldNames, Column::FieldLengths)
+               && mColumns[static_cast<size_t>(Column::StringOffsets)].mCount > 0
+               && GetColumn<uint32_t>(Column::StringOffsets).back() == mColumns[static_cast<size_t>(Column::StringData)].mCount;
+
+        return isValid;
+    }
+
+    bool ReflectionDatabase::IsOpen() const
+    {
+        return mIsOpen;
+    }
+
+    std::string_view ReflectionDatabase::GetString(uint32_t id) const
+    {
+        const std::span<const uint32_t> offsets = GetColumn<uint32_t>(Column::StringOffsets);
+        if (offsets.empty() || id >= offsets.size() - 1) return std::string_view();
+
+        // the terminator is left off
+        const std::span<const char> data = GetColumn<char>(Column::StringData);
+        return std::string_view(data.data() + offsets[id], offsets[id + 1] - offsets[id] - 1);
+    }
+
+    size_t ReflectionDatabase::GetFileCount() const
+    {
+        return static_cast<size_t>(mColumns[static_cast<size_t>(Column::FilePaths)].mCount);
+    }
+
+    size_t ReflectionDatabase::GetNamespaceCount() const
+    {
+        return static_cast<size_t>(mColumns[static_cast<size_t>(Column::NamespaceNames)].mCount);
+    }
+
+    size_t ReflectionDatabase::GetClassCount() const
+    {
+        return static_cast<size_t>(mColumns[static_cast<size_t>(Column::ClassNames)].mCount);
+    }
+
+    size_t ReflectionDatabase::GetFieldCount() const
+    {
+        return static_cast<size_t>(mColumns[static_cast<size_t>(Column::FieldNames)].mCount);
+    }
+
+    uint32_t ReflectionDatabase::FindNamespace(std::string_view path) const
+    {
+        return FindSorted(Column::NamespacePaths, path);
+    }
+
+    uint32_t ReflectionDatabase::FindClass(std::string_view path) const
+    {
+        return FindSorted(Column::ClassPaths, path);
+    }
+
+    inline uint32_t ReflectionDatabase::FindSorted(Column column, std::string_view path) const
+    {
+        const std::span<const uint32_t> paths = GetColumn<uint32_t>(column);
+
+        const auto found = std::lower_bound(paths.begin(), paths.end(), path, [this](uint32_t id, std::string_view path) { return GetString(id) < path; });
+        if (found == paths.end() || GetString(*found) != path) return sNoIndex;
+
+        return static_cast<uint32_t>(found - paths.begin());
+    }
+}
@@ -0,0 +1,171 @@
+/*****************************************************************//**
+ * \file   ReflectionDatabase.hpp
+ * \brief  binary database of every reflected class of the project. each
+ *         table is stored as flat columns so a reader uses the file
+ *         straight out of one mapping without parsing anything
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+
+// preprocessor
+#include "Keywords.hpp"
+#include "SourceFile.hpp"
+
+namespace gep
+{
+	class IncludeGraph;
+
+	// the name of the database inside of the meta folder
+	inline constexpr const char* sDatabaseName = "reflection.db";
+
+	// marks a missing namespace, outer class or string
+	inline constexpr uint32_t sNoIndex = UINT32_MAX;
+
+	// what a field is reflected for, a field marked by both keywords has both bits
+	enum FieldFlag : uint32_t
+	{
+		FieldPrintable    = 1 << 0,
+		FieldSerializable = 1 << 1,
+	};
+
+	// the flag a meta keyword sets on the field it marks
+	inline uint32_t GetFieldFlag(TokenKind keyword)
+	{
+		switch (keyword)
+		{
+		case TokenKind::Printable:    return FieldPrintable;
+		case TokenKind::Serializable: return FieldSerializable;
+		default:                      return 0;
+		}
+	}
+
+	// every column of a table has the same length. strings are indexes into the string table, everything else is a uint32_t unless noted
+	enum class Column : uint32_t
+	{
+		StringOffsets,    // one per string plus one, string i starts at offset i and ends one null before offset i + 1
+		StringData,       // char, every string followed by a null
+
+		FilePaths,        // absolute, sorted
+
+		NamespaceNames,
+		NamespacePaths,   // sorted
+		NamespaceParents, // namespace or sNoIndex
+
+		ClassNames,
+		ClassPaths,       // sorted
+		ClassNamespaces,  // the innermost namespace or sNoIndex
+		ClassOuters,      // the class it is nested in or sNoIndex
+		ClassFiles,       // the file it was first seen in
+		ClassFirstFields, // the fields of a class are contiguous
+		ClassFieldCounts,
+
+		FieldNames,
+		FieldTypes,
+		FieldClasses,
+		FieldFlags,       // FieldFlag bits
+		FieldLines,       // starting at 1
+		FieldOffsets,     // bytes from the start of the file of the class
+		FieldLengths,
+
+		Count
+	};
+
+	class ReflectionDatabase
+	{
+	public:
+		ReflectionDatabase();
+
+		// one owner per mapping
+		ReflectionDatabase(const ReflectionDatabase&) = delete;
+		ReflectionDatabase& operator=(const ReflectionDatabase&) = delete;
+
+		// lays out every class published to graph exactly as it is stored on disk
+		static std::string Build(const IncludeGraph& graph);
+
+		// writes Build to path, the file is replaced in one rename so readers never see half of it
+		static bool Write(const std::filesystem::path& path, const IncludeGraph& graph);
+
+		// maps the database, false if it is missing, truncated or from another version
+		bool Open(const std::filesystem::path& path);
+
+		// uses a database that was built in memory, false if data is not one
+		bool Load(std::string data);
+
+		void Close();
+
+		bool IsOpen() const;
+
+		// the raw values of a column, valid until the next Open or Close
+		template<typename T>
+		std::span<const T> GetColumn(Column column) const
+		{
+			const ColumnEntry& entry = mColumns[static_cast<size_t>(column)];
+			return std::span<const T>(reinterpret_cast<const T*>(mView.data() + entry.mOffset), static_cast<size_t>(entry.mCount));
+		}
+
+		// the string with index id, empty for sNoIndex
+		std::string_view GetString(uint32_t id) const;
+
+		size_t GetFileCount() const;
+		size_t GetNamespaceCount() const;
+		size_t GetClassCount() const;
+		size_t GetFieldCount() const;
+
+		// binary search of the sorted paths, sNoIndex if there is no match
+		uint32_t FindNamespace(std::string_view path) const;
+		uint32_t FindClass(std::string_view path) const;
+
+	private:
+		struct Header
+		{
+			char mMagic[4];
+			uint32_t mVersion;
+			uint32_t mColumnCount;
+			uint32_t mReserved;
+			uint64_t mSize; // of the whole file, catches truncated writes
+		};
+
+		// the header is followed by one entry per column
+		struct ColumnEntry
+		{
+			uint32_t mElementSize;
+			uint32_t mReserved;
+			uint64_t mOffset; // from the start of the file, a multiple of 8
+			uint64_t mCount;
+		};
+
+		// checks the header and the bounds of every column of mView
+		inline bool Validate();
+
+		// binary search of a sorted column of strings
+		inline uint32_t FindSorted(Column column, std::string_view path) const;
+
+	private:
+		// changes whenever the layout of a table changes
+		static constexpr uint32_t sVersion = 1;
+
+		SourceFile mFile;
+
+		// holds a database that was loaded rather than opened
+		std::string mBuffer;
+
+		// whichever of the two is in use
+		std::string_view mView;
+
+		// copied out of the mapping so they never need to be aligned
+		std::array<ColumnEntry, static_cast<size_t>(Column::Count)> mColumns;
+
+		bool mIsOpen;
+	};
+} // namespace gep
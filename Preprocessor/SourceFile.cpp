@@ -0,0 +1,169 @@
+/*****************************************************************//**
+ * \file   SourceFile.cpp
+ * \brief
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+// std
+#include <algorithm>
+#include <cerrno>
+
+// this
+#include "SourceFile.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gep
+{
+    SourceFile::SourceFile()
+        : mData(nullptr)
+        , mSize(0)
+        , mIsMapped(false)
+    {
+    }
+
+    SourceFile::~SourceFile()
+    {
+        Close();
+    }
+
+    bool SourceFile::Open(const std::filesystem::path& path)
+    {
+        Close();
+
+        // one open and one stat decide between mapping and reading
+#ifdef _WIN32
+        // writers publish by renaming a temp file over this one, which fails unless the open handle shares delete and write
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER info;
+        const bool isDisk = GetFileType(file) == FILE_TYPE_DISK && GetFileSizeEx(file, &info);
+        const size_t size = isDisk ? static_cast<size_t>(info.QuadPart) : 0;
+
+        const bool isOpen = (isDisk && size >= sMapThreshold && Map(file, size)) || ReadBuffered(file, size);
+        CloseHandle(file);
+#else
+        const int file = open(path.c_str(), O_RDONLY);
+        if (file < 0) return false;
+
+        struct stat info;
+        const bool isRegular = fstat(file, &info) == 0 && S_ISREG(info.st_mode);
+        const size_t size = isRegular ? static_cast<size_t>(info.st_size) : 0;
+
+        const bool isOpen = (isRegular && size >= sMapThreshold && Map(file, size)) || ReadBuffered(file, size);
+        close(file);
+#endif
+
+        return isOpen;
+    }
+
+    void SourceFile::Close()
+    {
+        if (mIsMapped)
+        {
+#ifdef _WIN32
+            UnmapViewOfFile(mData);
+#else
+            munmap(const_cast<char*>(mData), mSize);
+#endif
+        }
+
+        mData = nullptr;
+        mSize = 0;
+        mIsMapped = false;
+        mBuffer.clear();
+    }
+
+    std::string_view SourceFile::View() const
+    {
+        return std::string_view(mData, mSize);
+    }
+
+    bool SourceFile::IsMapped() const
+    {
+        return mIsMapped;
+    }
+
+    bool SourceFile::ReadBuffered(NativeFile file, size_t size)
+    {
+        // pipes have no size up front so read in large chunks until the end
+        constexpr size_t chunkSize = 64 * 1024;
+
+        // one spare byte so a file that did not grow is read without resizing again to find the end
+        mBuffer.resize(std::max(size + 1, chunkSize));
+
+        size_t used = 0;
+        while (true)
+        {
+            if (used == mBuffer.size()) mBuffer.resize(used + chunkSize);
+
+            const size_t request = mBuffer.size() - used;
+#ifdef _WIN32
+            DWORD count = 0;
+            if (!ReadFile(file, mBuffer.data() + used, static_cast<DWORD>(std::min<size_t>(request, MAXDWORD)), &count, nullptr))
+            {
+                // the write end of a pipe closing is the end of the file
+                if (GetLastError() == ERROR_BROKEN_PIPE) break;
+
+                mBuffer.clear();
+                return false;
+            }
+#else
+            const ssize_t count = read(file, mBuffer.data() + used, request);
+            if (count < 0)
+            {
+                if (errno == EINTR) continue;
+
+                mBuffer.clear();
+                return false;
+            }
+#endif
+            if (count == 0) break;
+
+            used += static_cast<size_t>(count);
+        }
+
+        mBuffer.resize(used);
+        mData = mBuffer.data();
+        mSize = mBuffer.size();
+
+        return true;
+    }
+
+    bool SourceFile::Map(NativeFile file, size_t size)
+    {
+#ifdef _WIN32
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return false;
+
+        // the view keeps its own reference to the mapping object
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (!view) return false;
+#else
+        void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (view == MAP_FAILED) return false;
+
+        // the lexer reads front to back exactly once
+        madvise(view, size, MADV_SEQUENTIAL);
+#endif
+
+        mData = static_cast<const char*>(view);
+        mSize = size;
+        mIsMapped = true;
+
+        return true;
+    }
+}
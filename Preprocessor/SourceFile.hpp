@@ -0,0 +1,69 @@
+/*****************************************************************//**
+ * \file   SourceFile.hpp
+ * \brief  read only view of a file on disk, memory mapped when the file
+ *         is large enough for mapping to pay off
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace gep
+{
+	class SourceFile
+	{
+	public:
+		SourceFile();
+		~SourceFile();
+
+		// a mapping has exactly one owner
+		SourceFile(const SourceFile&) = delete;
+		SourceFile& operator=(const SourceFile&) = delete;
+
+		// maps or reads the file, closing whatever was open before. returns false if the file could not be opened
+		bool Open(const std::filesystem::path& path);
+
+		// unmaps or frees the current contents
+		void Close();
+
+		// the contents of the file, valid until the next Open or Close
+		std::string_view View() const;
+
+		// true if the contents are memory mapped rather than copied
+		bool IsMapped() const;
+
+	private:
+#ifdef _WIN32
+		// a HANDLE, the header does not pull in Windows.h
+		using NativeFile = void*;
+#else
+		using NativeFile = int;
+#endif
+
+		// reads pipes, small files and anything that fails to map into mBuffer until the end, size is only a hint.
+		// returns false on a read error so a truncated file is never used as if it were complete
+		inline bool ReadBuffered(NativeFile file, size_t size);
+
+		// attempts to map size bytes of a regular file, returns false so the caller can fall back to reading
+		inline bool Map(NativeFile file, size_t size);
+
+	private:
+		// files smaller than this are cheaper to copy than to map
+		static constexpr size_t sMapThreshold = 64 * 1024;
+
+		const char* mData;
+
+		size_t mSize;
+
+		bool mIsMapped;
+
+		// holds the contents when they are not mapped
+		std::string mBuffer;
+	};
+} // namespace gep
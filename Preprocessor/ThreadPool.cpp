@@ -0,0 +1,159 @@
+/*****************************************************************//**
+ * \file   ThreadPool.cpp
+ * \brief
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+// this
+#include "ThreadPool.hpp"
+
+namespace gep
+{
+    ThreadPool::ThreadPool(size_t threadCount)
+        : mTask(nullptr)
+        , mRemaining(0)
+        , mGeneration(0)
+        , mStop(false)
+    {
+        if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) threadCount = 1;
+
+        for (size_t i = 0; i < threadCount; i++)
+        {
+            mQueues.push_back(std::make_unique<Queue>());
+        }
+
+        for (size_t worker = 1; worker < threadCount; worker++)
+        {
+            mThreads.emplace_back(&ThreadPool::WorkerLoop, this, worker);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mWake.notify_all();
+
+        for (std::thread& thread : mThreads)
+        {
+            thread.join();
+        }
+    }
+
+    void ThreadPool::Run(size_t count, const Task& task)
+    {
+        if (count == 0) return;
+
+        const size_t workers = mQueues.size();
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+
+            mTask = &task;
+            mRemaining = count;
+
+            // contiguous ranges keep neighbouring files on one worker, stealing evens out whatever is left
+            for (size_t worker = 0; worker < workers; worker++)
+            {
+                std::lock_guard<std::mutex> queueLock(mQueues[worker]->mMutex);
+
+                const size_t first = count * worker / workers;
+                const size_t last = count * (worker + 1) / workers;
+                for (size_t index = first; index < last; index++)
+                {
+                    mQueues[worker]->mTasks.push_back(index);
+                }
+            }
+
+            mGeneration++;
+        }
+        mWake.notify_all();
+
+        // the calling thread works instead of waiting
+        Drain(0);
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDone.wait(lock, [this]() { return mRemaining == 0; });
+
+        mTask = nullptr;
+    }
+
+    size_t ThreadPool::GetThreadCount() const
+    {
+        return mQueues.size();
+    }
+
+    void ThreadPool::WorkerLoop(size_t worker)
+    {
+        uint64_t seenGeneration = 0;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mWake.wait(lock, [&]() { return mStop || mGeneration != seenGeneration; });
+
+                if (mStop) return;
+
+                seenGeneration = mGeneration;
+            }
+
+            Drain(worker);
+        }
+    }
+
+    void ThreadPool::Drain(size_t worker)
+    {
+        size_t index;
+        while (Pop(worker, index) || Steal(worker, index))
+        {
+            (*mTask)(worker, index);
+
+            // the last task to finish wakes Run
+            if (mRemaining.fetch_sub(1) == 1)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mDone.notify_all();
+            }
+        }
+    }
+
+    bool ThreadPool::Pop(size_t worker, size_t& index)
+    {
+        Queue& queue = *mQueues[worker];
+        std::lock_guard<std::mutex> lock(queue.mMutex);
+
+        if (queue.mTasks.empty()) return false;
+
+        index = queue.mTasks.front();
+        queue.mTasks.pop_front();
+
+        return true;
+    }
+
+    bool ThreadPool::Steal(size_t thief, size_t& index)
+    {
+        const size_t workers = mQueues.size();
+
+        // tasks are never added during a batch, so one empty sweep means there is nothing left to take
+        for (size_t offset = 1; offset < workers; offset++)
+        {
+            Queue& victim = *mQueues[(thief + offset) % workers];
+            std::lock_guard<std::mutex> lock(victim.mMutex);
+
+            if (victim.mTasks.empty()) continue;
+
+            index = victim.mTasks.back();
+            victim.mTasks.pop_back();
+
+            return true;
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,92 @@
+/*****************************************************************//**
+ * \file   ThreadPool.hpp
+ * \brief  fixed set of worker threads that run a batch of indexed tasks,
+ *         each worker has its own queue and steals from the others once
+ *         it runs dry
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gep
+{
+	class ThreadPool
+	{
+	public:
+		// called with the worker running the task and the index of the task
+		using Task = std::function<void(size_t worker, size_t index)>;
+
+		// 0 uses every hardware thread, the thread calling Run counts as one of them
+		explicit ThreadPool(size_t threadCount = 0);
+
+		// joins every thread, must not be called while Run is in progress
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		// runs task for every index below count and returns once all of them finished
+		void Run(size_t count, const Task& task);
+
+		// the number of workers including the calling thread
+		size_t GetThreadCount() const;
+
+	private:
+		struct Queue
+		{
+			std::mutex mMutex;
+			std::deque<size_t> mTasks;
+		};
+
+		// waits for a batch, works on it, then waits again until the pool is destroyed
+		inline void WorkerLoop(size_t worker);
+
+		// runs tasks until every queue is empty
+		inline void Drain(size_t worker);
+
+		// takes the next task from the front of the worker's own queue
+		inline bool Pop(size_t worker, size_t& index);
+
+		// takes a task from the back of another worker's queue, the end its owner is furthest from
+		inline bool Steal(size_t thief, size_t& index);
+
+	private:
+		// one per worker, index 0 belongs to the thread calling Run
+		std::vector<std::unique_ptr<Queue>> mQueues;
+
+		// every worker except worker 0
+		std::vector<std::thread> mThreads;
+
+		// the task of the batch in progress
+		const Task* mTask;
+
+		// tasks that have not finished yet
+		std::atomic<size_t> mRemaining;
+
+		std::mutex mMutex;
+
+		// signals a new batch or shutdown
+		std::condition_variable mWake;
+
+		// signals the last task of a batch finished
+		std::condition_variable mDone;
+
+		// bumped for every batch so a worker knows it has not seen it yet
+		uint64_t mGeneration;
+
+		bool mStop;
+	};
+} // namespace gep
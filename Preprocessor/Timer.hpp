@@ -6,8 +6,12 @@
  * \date   May 2024
  *********************************************************************/
 
+#pragma once
+
 #include <chrono>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 
 namespace gep
 {
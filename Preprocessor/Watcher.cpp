@@ -0,0 +1,232 @@
+/*****************************************************************//**
+ * \file   Watcher.cpp
+ * \brief
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+// std
+#include <thread>
+
+#include <OutStream.hpp>
+
+// this
+#include "Watcher.hpp"
+
+#include "Batch.hpp"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace gep
+{
+    namespace
+    {
+        // hidden folders such as .meta, .git and .vs never hold source, and .meta is written to on every burst
+        bool IsSkippedDirectory(const std::filesystem::path& directory)
+        {
+            const std::string name = directory.filename().string();
+            return !name.empty() && name[0] == '.';
+        }
+    }
+
+    Watcher::Watcher(Batch& batch, const std::vector<std::string>& extensions)
+        : mBatch(batch)
+        , mExtensions(extensions)
+#ifdef __linux__
+        , mInotify(-1)
+#endif
+    {
+        if (mExtensions.empty()) mExtensions = { ".hpp", ".h", ".hxx", ".hh" };
+    }
+
+    Watcher::~Watcher()
+    {
+#ifdef __linux__
+        if (mInotify >= 0) close(mInotify);
+#endif
+    }
+
+    bool Watcher::Run(const std::vector<std::filesystem::path>& directories)
+    {
+        mDirectories = directories;
+
+#ifdef __linux__
+        mInotify = inotify_init1(IN_CLOEXEC);
+        if (mInotify < 0)
+        {
+            gep::cerr << "Failed to start inotify" << std::endl;
+            return false;
+        }
+
+        // watches are added before the first pass so nothing saved during it is missed
+        for (const std::filesystem::path& directory : mDirectories)
+        {
+            AddWatch(directory, false);
+        }
+#endif
+
+        // everything is brought up to date before waiting for changes
+        const std::vector<std::filesystem::path> files = mBatch.FindFiles(mDirectories, mExtensions);
+        mBatch.Run(files);
+
+        // the loop never returns so the cache is flushed after every run rather than when it is destroyed
+        mBatch.GetPreprocessor().FlushCache();
+
+#ifndef __linux__
+        for (const std::filesystem::path& file : files)
+        {
+            std::error_code error;
+            mWriteTimes[file] = std::filesystem::last_write_time(file, error);
+        }
+#endif
+
+        gep::cout << "Watching " << mDirectories.size() << " directories for changes" << std::endl;
+
+        while (true)
+        {
+            const clock_t::duration quiet = clock_t::now() - mLastChange;
+
+            // the burst is over, only the files it touched are preprocessed
+            if (!mChanged.empty() && quiet >= sDebounce)
+            {
+                const std::vector<std::filesystem::path> changed(mChanged.begin(), mChanged.end());
+                mChanged.clear();
+
+                mBatch.Run(changed);
+                mBatch.GetPreprocessor().FlushCache();
+                continue;
+            }
+
+            int timeout = -1;
+            if (!mChanged.empty())
+            {
+                timeout = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(sDebounce - quiet).count());
+            }
+
+            WaitForChanges(timeout);
+        }
+
+        return true;
+    }
+
+    void Watcher::AddChange(const std::filesystem::path& path)
+    {
+        if (!Batch::HasExtension(path, mExtensions)) return;
+
+        mChanged.insert(path.lexically_normal());
+        mLastChange = clock_t::now();
+    }
+
+#ifdef __linux__
+    void Watcher::WaitForChanges(int timeoutMilliseconds)
+    {
+        pollfd descriptor = {};
+        descriptor.fd = mInotify;
+        descriptor.events = POLLIN;
+
+        if (poll(&descriptor, 1, timeoutMilliseconds) > 0) ReadEvents();
+    }
+
+    void Watcher::AddWatch(const std::filesystem::path& directory, bool isNew)
+    {
+        const int watch = inotify_add_watch(mInotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR);
+        if (watch < 0) return;
+
+        mWatches[watch] = directory;
+
+        // inotify is not recursive, every directory below needs its own watch
+        std::error_code error;
+        std::filesystem::directory_iterator it(directory, error);
+
+        for (; !error && it != std::filesystem::directory_iterator(); it.increment(error))
+        {
+            const std::filesystem::directory_entry& entry = *it;
+
+            std::error_code typeError;
+            if (entry.is_directory(typeError))
+            {
+                if (!IsSkippedDirectory(entry.path()) && !entry.is_symlink(typeError)) AddWatch(entry.path(), isNew);
+            }
+            else if (isNew)
+            {
+                // a directory that was moved in brings its files with it
+                AddChange(entry.path());
+            }
+        }
+    }
+
+    void Watcher::ReadEvents()
+    {
+        alignas(inotify_event) char buffer[64 * 1024];
+
+        const ssize_t length = read(mInotify, buffer, sizeof(buffer));
+        if (length <= 0) return;
+
+        for (const char* position = buffer; position < buffer + length;)
+        {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(position);
+            position += sizeof(inotify_event) + event->len;
+
+            // the kernel dropped events, the only safe thing left is to treat every file as changed
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                for (const std::filesystem::path& file : mBatch.FindFiles(mDirectories, mExtensions)) AddChange(file);
+                continue;
+            }
+
+            // the directory was removed
+            if (event->mask & IN_IGNORED)
+            {
+                mWatches.erase(event->wd);
+                continue;
+            }
+
+            const auto watch = mWatches.find(event->wd);
+            if (watch == mWatches.end() || event->len == 0) continue;
+
+            const std::filesystem::path path = watch->second / event->name;
+
+            if (event->mask & IN_ISDIR)
+            {
+                if ((event->mask & (IN_CREATE | IN_MOVED_TO)) && !IsSkippedDirectory(path)) AddWatch(path, true);
+            }
+            else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+            {
+                AddChange(path);
+            }
+        }
+    }
+#else
+    void Watcher::WaitForChanges(int timeoutMilliseconds)
+    {
+        std::chrono::milliseconds wait = sPollInterval;
+        if (timeoutMilliseconds >= 0 && std::chrono::milliseconds(timeoutMilliseconds) < wait) wait = std::chrono::milliseconds(timeoutMilliseconds);
+
+        std::this_thread::sleep_for(wait);
+
+        Poll();
+    }
+
+    void Watcher::Poll()
+    {
+        for (const std::filesystem::path& file : mBatch.FindFiles(mDirectories, mExtensions))
+        {
+            std::error_code error;
+            const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(file, error);
+            if (error) continue;
+
+            // new files have no entry and always count as changed
+            const auto found = mWriteTimes.find(file);
+            if (found != mWriteTimes.end() && found->second == writeTime) continue;
+
+            mWriteTimes[file] = writeTime;
+            AddChange(file);
+        }
+    }
+#endif
+}
@@ -0,0 +1,88 @@
+/*****************************************************************//**
+ * \file   Watcher.hpp
+ * \brief  watches directories for header changes and regenerates only
+ *         the meta files of the headers that changed, uses inotify on
+ *         linux and polls everywhere else
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+// std
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gep
+{
+	class Batch;
+
+	class Watcher
+	{
+	public:
+		// files with one of extensions are watched, empty watches the usual header extensions
+		Watcher(Batch& batch, const std::vector<std::string>& extensions);
+
+		~Watcher();
+
+		Watcher(const Watcher&) = delete;
+		Watcher& operator=(const Watcher&) = delete;
+
+		// preprocesses every file once then watches forever, a burst of changes is preprocessed once nothing changed for the debounce window
+		bool Run(const std::vector<std::filesystem::path>& directories);
+
+	private:
+		// adds a file to the current burst if it is watched
+		inline void AddChange(const std::filesystem::path& path);
+
+		// blocks until a change arrives or the timeout passes, timeout of -1 waits forever
+		inline void WaitForChanges(int timeoutMilliseconds);
+
+#ifdef __linux__
+		// watches directory and everything below it, files inside of it are treated as changed when isNew
+		inline void AddWatch(const std::filesystem::path& directory, bool isNew);
+
+		inline void ReadEvents();
+#else
+		// compares the write time of every file against the last scan
+		inline void Poll();
+#endif
+
+	private:
+		using clock_t = std::chrono::steady_clock;
+
+		// how long a burst has to be quiet before it is preprocessed, editors often save more than once
+		static constexpr std::chrono::milliseconds sDebounce = std::chrono::milliseconds(100);
+
+		Batch& mBatch;
+
+		std::vector<std::string> mExtensions;
+
+		std::vector<std::filesystem::path> mDirectories;
+
+		// files changed since the last burst was preprocessed, sorted so output stays in the same order
+		std::set<std::filesystem::path> mChanged;
+
+		// when the newest change of the current burst arrived
+		clock_t::time_point mLastChange;
+
+#ifdef __linux__
+		int mInotify;
+
+		// the directory of every watch descriptor
+		std::unordered_map<int, std::filesystem::path> mWatches;
+#else
+		// how often the directories are rescanned
+		static constexpr std::chrono::milliseconds sPollInterval = std::chrono::milliseconds(250);
+
+		// the last write time of every watched file
+		std::map<std::filesystem::path, std::filesystem::file_time_type> mWriteTimes;
+#endif
+	};
+} // namespace gep
@@ -14,9 +14,15 @@
 #include <thread>
 #include <chrono>
 #include <filesystem>
+#include <cstdlib>
 
 // preprocessor
+#include "Batch.hpp"
+#include "Daemon.hpp"
+#include "Watcher.hpp"
 #include "Preprocessor.hpp"
+#include "Profiler.hpp"
+#include "ReflectionDatabase.hpp"
 #include <Printing.hpp>
 #include <OutStream.hpp>
 
@@ -34,28 +40,216 @@ int main(int argc, char** argv)
         arguments.push_back(argv[i]);
     }
 
-    // create the preprocessor object
-    gep::Preprocessor preprocessor;
+    // prints cache hits and misses once every file is done
+    bool printStats = false;
 
-    // intialize the preprocessor
-    preprocessor.InitializeMetaHeader();
+    // prints the time spent in each stage once every file is done
+    bool printProfile = false;
+
+    // writes every stage of every file as a chrome trace
+    std::filesystem::path tracePath;
+
+    // copies the include files before any file is processed
+    bool getFiles = false;
+
+    // finds every header of the project described by pconfig.json
+    bool isProject = false;
+
+    // also preprocesses the user headers that the files include, each one once
+    bool isFollowing = false;
+
+    // writes every reflected class to a binary database inside of the meta folder after each run
+    bool writeDatabase = false;
+
+    // stays running and serves clients over a local socket
+    bool isDaemon = false;
+
+    // forwards to a running daemon, working in process when there is none
+    bool isClient = false;
+
+    // asks a running daemon to exit
+    bool stopDaemon = false;
+
+    // regenerates meta files whenever a header in one of the watched directories changes
+    bool isWatching = false;
+    std::vector<std::filesystem::path> watchDirectories;
+
+    // worker threads, -j 0 uses every hardware thread
+    size_t threadCount = 1;
 
-    // preprocess all of the arguments
-    for (const std::string& argument : arguments)
+    std::vector<std::filesystem::path> files;
+
+    // sorts the arguments into commands and files
+    for (size_t i = 0; i < arguments.size(); i++)
     {
+        const std::string& argument = arguments[i];
+
         // checks if the cureent argument is a command
         if (argument[0] == '-')
         {
             if (argument == "-getfiles")
             {
-                gep::cout << "Grabbing include files..." << std::endl;
-                preprocessor.GenerateIncludes();
+                getFiles = true;
+            }
+            else if (argument == "-project")
+            {
+                isProject = true;
+            }
+            else if (argument == "-follow")
+            {
+                isFollowing = true;
+            }
+            else if (argument == "-database")
+            {
+                writeDatabase = true;
+            }
+            else if (argument == "-watch")
+            {
+                isWatching = true;
+
+                // every argument up to the next command is a directory
+                while (i + 1 < arguments.size() && arguments[i + 1][0] != '-')
+                {
+                    watchDirectories.push_back(arguments[++i]);
+                }
+            }
+            else if (argument == "-daemon")
+            {
+                isDaemon = true;
+            }
+            else if (argument == "-client")
+            {
+                isClient = true;
+            }
+            else if (argument == "-stopdaemon")
+            {
+                stopDaemon = true;
+            }
+            else if (argument == "--stats")
+            {
+                printStats = true;
+            }
+            else if (argument == "--profile")
+            {
+                printProfile = true;
+            }
+            else if (argument == "--trace")
+            {
+                // the next argument is the file unless it is another command
+                tracePath = (i + 1 < arguments.size() && arguments[i + 1][0] != '-') ? arguments[++i] : "trace.json";
+            }
+            else if (argument.rfind("-j", 0) == 0)
+            {
+                // accepts both -j 8 and -j8
+                const std::string count = (argument.length() > 2 || i + 1 >= arguments.size()) ? argument.substr(2) : arguments[++i];
+                threadCount = std::strtoull(count.c_str(), nullptr, 10);
             }
         }
         else
         {
-            preprocessor.PreprocessFile(argument);
+            files.push_back(argument);
+        }
+    }
+
+    // a thin client starts no workers when a daemon can do the work
+    if (isClient || stopDaemon)
+    {
+        using Command = gep::Daemon::Command;
+        const Command command = stopDaemon ? Command::Stop : (isProject ? Command::Project : Command::Preprocess);
+
+        std::string output;
+        size_t failures = 0;
+        if (gep::Daemon::Forward(gep::sDaemonSocketName, command, files, output, failures))
+        {
+            std::cout << output << std::flush;
+            return 0;
         }
+
+        if (stopDaemon)
+        {
+            gep::cwar << "No daemon is running for this directory" << std::endl;
+            return 0;
+        }
+    }
+
+    // recording has to start before any worker touches a file
+    if (printProfile || !tracePath.empty())
+    {
+        gep::Profiler::Enable(!tracePath.empty());
+    }
+
+    // creates one preprocessor per worker
+    gep::Batch batch(threadCount);
+    batch.SetFollowIncludes(isFollowing);
+
+    // the config decides where output goes, so it is read before initializing
+    if (isProject)
+    {
+        gep::Preprocessor& preprocessor = batch.GetPreprocessor();
+
+        if (!preprocessor.HasConfig())
+        {
+            gep::cwar << "No " << gep::sConfigName << " was found, creating one" << std::endl;
+            preprocessor.CreateConfig();
+        }
+
+        if (preprocessor.ReadConfig())
+        {
+            batch.SetConfig(preprocessor.GetConfig());
+
+            const std::vector<std::filesystem::path> projectFiles = batch.FindProjectFiles(preprocessor.GetConfig());
+            files.insert(files.end(), projectFiles.begin(), projectFiles.end());
+        }
+    }
+
+    // intialize the preprocessor
+    batch.GetPreprocessor().InitializeMetaHeader();
+
+    if (getFiles)
+    {
+        gep::cout << "Grabbing include files..." << std::endl;
+        batch.GetPreprocessor().GenerateIncludes();
+    }
+
+    // the meta folder is only known once the config is read
+    if (writeDatabase)
+    {
+        batch.SetDatabasePath(batch.GetPreprocessor().GetMetaPath() / gep::sDatabaseName);
+    }
+
+    // preprocess all of the files
+    batch.Run(files);
+
+    // keeps the workers, interner, cache and config warm until a client stops it
+    if (isDaemon)
+    {
+        gep::Daemon daemon(batch);
+        daemon.Run(gep::sDaemonSocketName);
+    }
+
+    // runs until the process is stopped
+    if (isWatching)
+    {
+        if (watchDirectories.empty()) watchDirectories.push_back(".");
+
+        gep::Watcher watcher(batch, batch.GetPreprocessor().GetConfig().mFileExtensions);
+        watcher.Run(watchDirectories);
+    }
+
+    if (printStats)
+    {
+        batch.PrintStats();
+    }
+
+    if (printProfile)
+    {
+        gep::Profiler::PrintSummary();
+    }
+
+    if (!tracePath.empty())
+    {
+        if (gep::Profiler::WriteTrace(tracePath)) gep::cout << "Trace written to " << tracePath << std::endl;
+        else                                      gep::cerr << "Failed to write the trace to " << tracePath << std::endl;
     }
 
     return 0;
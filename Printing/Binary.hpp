@@ -0,0 +1,550 @@
+/*****************************************************************//**
+ * \file   Binary.hpp
+ * \brief  compact binary encoding of serializable types. integers are
+ *         varints, floats and other trivially copyable values are stored
+ *         as their bytes, and the fields carry no tags because the
+ *         schema hash at the front says exactly what follows
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "Buffer.hpp"
+
+namespace gep
+{
+	namespace binary
+	{
+		// raw values are copied as they are, which is only the stored byte order on little endian machines
+		static_assert(std::endian::native == std::endian::little, "the binary format is little endian");
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// partially specialized in the meta file of every class with serializable fields. the specialization
+		/// has a static schema(depth), the hash of the name and type of every field mixed with the schema of
+		/// what the field holds, and static encode and decode templates
+		template <typename Type>
+		struct Codec {};
+
+		class Encoder;
+		class Decoder;
+
+		// backend implementation
+		namespace detail
+		{
+			template <typename Type>
+			concept has_codec = requires { Codec<Type>::schema(size_t()); };
+
+			template <typename Type>
+			concept is_range = requires(const Type& range) { std::begin(range); std::end(range); };
+
+			// stored as its bytes, integers and enums are varints and containers are stored element by element.
+			// pointers are addresses in the process that wrote them so they are never stored at all
+			template <typename Type>
+			concept is_raw = std::is_trivially_copyable_v<Type> && !std::is_integral_v<Type> && !std::is_enum_v<Type>
+				&& !std::is_pointer_v<Type> && !std::is_member_pointer_v<Type> && !has_codec<Type> && !is_range<Type>;
+
+			// elements a contiguous container stores as one block, bytes are never worse off copied than as varints
+			template <typename Type>
+			concept is_block_element = is_raw<Type> || (std::is_integral_v<Type> && sizeof(Type) == 1 && !std::is_same_v<Type, bool>);
+
+			template <typename Type>
+			concept is_map = requires { typename Type::key_type; typename Type::mapped_type; };
+
+			template <typename Type>
+			concept is_set = requires(Type& set, typename Type::key_type key) { set.insert(std::move(key)); } && !is_map<Type>;
+
+			template <typename Type>
+			concept is_sequence = requires(Type& sequence) { sequence.emplace_back(); sequence.clear(); };
+
+			template <typename Type>
+			struct is_std_array : std::false_type {};
+
+			template <typename Type, size_t Size>
+			struct is_std_array<std::array<Type, Size>> : std::true_type {};
+
+			// small negative numbers become small varints
+			inline uint64_t zigzag(int64_t value)
+			{
+				return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+			}
+
+			inline int64_t unzigzag(uint64_t value)
+			{
+				return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+			}
+
+			// how many classes deep a schema follows nested classes, a class that holds itself would never end
+			inline constexpr size_t sSchemaDepth = 8;
+
+			// the schema written in front of an item of Type, classes and containers mix in the schema of what they hold
+			template <typename Type>
+			constexpr uint64_t schema_of(size_t depth = 0)
+			{
+				if constexpr (has_codec<Type>)
+				{
+					return Codec<Type>::schema(depth);
+				}
+				else if constexpr (is_map<Type>)
+				{
+					return (schema_of<typename Type::key_type>(depth) * 31 + schema_of<typename Type::mapped_type>(depth)) * 0x9E3779B97F4A7C15ull;
+				}
+				else if constexpr (is_range<Type>)
+				{
+					return (schema_of<std::ranges::range_value_t<Type>>(depth) + 1) * 0x9E3779B97F4A7C15ull;
+				}
+				else
+				{
+					return (sizeof(Type) << 2 | std::is_floating_point_v<Type> << 1 | std::is_signed_v<Type>) * 0xC4CEB9FE1A85EC53ull;
+				}
+			}
+
+			/////////////////////////////////////////////////////////////////////////////////////////////////
+			/// the schema of a class, hash covers its own field names and types and every field mixes in the
+			/// schema of its type, so a nested class that changes its layout changes the schema of the outer one
+			template <typename... Fields>
+			constexpr uint64_t class_schema(uint64_t hash, size_t depth)
+			{
+				if (depth >= sSchemaDepth) return hash;
+
+				((hash = (hash ^ schema_of<std::remove_cv_t<Fields>>(depth + 1)) * 0xFF51AFD7ED558CCDull), ...);
+				return hash;
+			}
+		}
+
+		class Encoder
+		{
+		public:
+			// appends the schema of Type followed by item, nothing is allocated once the output has grown to fit
+			template <typename Type>
+			void Encode(const Type& item);
+
+			// everything encoded since the last Clear
+			std::string_view GetOutput() const;
+
+			// empties the output but keeps its memory
+			void Clear();
+
+			// writes the output to path in one call, false if it could not be written
+			bool Save(const std::filesystem::path& path) const;
+
+			// appends one value without a schema, the generated codecs call it for fields that are not copied as part of a run
+			template <typename Type>
+			void Value(const Type& item);
+
+			// appends fields in order. raw fields that follow each other in memory with nothing in between are copied with one memcpy
+			void Fields() {}
+
+			template <typename First, typename... Rest>
+			void Fields(const First& first, const Rest&... rest);
+
+			void Varint(uint64_t value);
+
+			void Bytes(const void* data, size_t size);
+
+		private:
+			// grows a run of raw bytes that starts at begin by every following raw field stored right after it
+			void Run(const char* begin, size_t size)
+			{
+				Bytes(begin, size);
+			}
+
+			template <typename Next, typename... Rest>
+			void Run(const char* begin, size_t size, const Next& next, const Rest&... rest);
+
+		private:
+			gep::Buffer mOutput;
+		};
+
+		class Decoder
+		{
+		public:
+			Decoder() = default;
+
+			// data must outlive the decoder
+			explicit Decoder(std::string_view data);
+
+			void SetInput(std::string_view data);
+
+			// false if the schema in front of the data is not the one of Type or the data ends early.
+			// a matching schema means the layout is known, so fields are read back to back with no tags to check
+			template <typename Type>
+			bool Decode(Type& item);
+
+			// the decoding counterparts of the encoder, false once the data runs out
+			template <typename Type>
+			bool Value(Type& item);
+
+			bool Fields() { return true; }
+
+			template <typename First, typename... Rest>
+			bool Fields(First& first, Rest&... rest);
+
+			bool Varint(uint64_t& value);
+
+			bool Bytes(void* data, size_t size);
+
+			// the bytes that were not read yet
+			size_t GetRemaining() const;
+
+		private:
+			template <typename Next, typename... Rest>
+			bool Run(char* begin, size_t size, Next& next, Rest&... rest);
+
+			bool Run(char* begin, size_t size)
+			{
+				return Bytes(begin, size);
+			}
+
+		private:
+			const char* mCursor = nullptr;
+			const char* mEnd = nullptr;
+		};
+	}
+}
+
+template<typename Type>
+inline void gep::binary::Encoder::Encode(const Type& item)
+{
+	const uint64_t schema = detail::schema_of<Type>();
+	Bytes(&schema, sizeof(schema));
+
+	Value(item);
+}
+
+inline std::string_view gep::binary::Encoder::GetOutput() const
+{
+	return mOutput.View();
+}
+
+inline void gep::binary::Encoder::Clear()
+{
+	mOutput.Clear();
+}
+
+inline bool gep::binary::Encoder::Save(const std::filesystem::path& path) const
+{
+	const std::string_view output = mOutput.View();
+
+	std::ofstream file(path, std::ios::binary);
+	file.write(output.data(), static_cast<std::streamsize>(output.size()));
+
+	return static_cast<bool>(file.flush());
+}
+
+template<typename Type>
+inline void gep::binary::Encoder::Value(const Type& item)
+{
+	if constexpr (detail::has_codec<Type>)
+	{
+		Codec<Type>::encode(*this, item);
+	}
+	else if constexpr (std::is_same_v<Type, bool>)
+	{
+		mOutput.Push(item ? 1 : 0);
+	}
+	else if constexpr (std::is_enum_v<Type>)
+	{
+		Value(static_cast<std::underlying_type_t<Type>>(item));
+	}
+	else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+	{
+		Varint(detail::zigzag(item));
+	}
+	else if constexpr (std::is_integral_v<Type>)
+	{
+		Varint(item);
+	}
+	else if constexpr (detail::is_raw<Type>)
+	{
+		Bytes(&item, sizeof(item));
+	}
+	else if constexpr (detail::is_std_array<Type>::value)
+	{
+		// the size is part of the type so only the elements are stored
+		if constexpr (detail::is_block_element<typename Type::value_type>) Bytes(item.data(), sizeof(item));
+		else for (const auto& element : item) Value(element);
+	}
+	else if constexpr (detail::is_range<Type>)
+	{
+		Varint(static_cast<uint64_t>(std::ranges::distance(item)));
+
+		// strings and vectors of raw values are one copy
+		if constexpr (std::ranges::contiguous_range<Type> && detail::is_block_element<std::ranges::range_value_t<Type>>)
+		{
+			Bytes(std::ranges::data(item), std::ranges::size(item) * sizeof(std::ranges::range_value_t<Type>));
+		}
+		else if constexpr (detail::is_map<Type>)
+		{
+			for (const auto& [key, value] : item)
+			{
+				Value(key);
+				Value(value);
+			}
+		}
+		else
+		{
+			for (const auto& element : item) Value(element);
+		}
+	}
+	else
+	{
+		static_assert(!sizeof(Type), "this type cannot be encoded, mark its fields serializable");
+	}
+}
+
+template<typename First, typename... Rest>
+inline void gep::binary::Encoder::Fields(const First& first, const Rest&... rest)
+{
+	if constexpr (detail::is_raw<First>)
+	{
+		Run(reinterpret_cast<const char*>(std::addressof(first)), sizeof(First), rest...);
+	}
+	else
+	{
+		Value(first);
+		Fields(rest...);
+	}
+}
+
+template<typename Next, typename... Rest>
+inline void gep::binary::Encoder::Run(const char* begin, size_t size, const Next& next, const Rest&... rest)
+{
+	// padding or a field the compiler moved ends the run, it costs one compare per field and folds away wherever this is inlined
+	if constexpr (detail::is_raw<Next>)
+	{
+		if (reinterpret_cast<const char*>(std::addressof(next)) == begin + size) return Run(begin, size + sizeof(Next), rest...);
+	}
+
+	Bytes(begin, size);
+	Fields(next, rest...);
+}
+
+inline void gep::binary::Encoder::Varint(uint64_t value)
+{
+	char* out = mOutput.Reserve(10);
+
+	size_t size = 0;
+	while (value >= 0x80)
+	{
+		out[size++] = static_cast<char>(value | 0x80);
+		value >>= 7;
+	}
+	out[size++] = static_cast<char>(value);
+
+	mOutput.Commit(size);
+}
+
+inline void gep::binary::Encoder::Bytes(const void* data, size_t size)
+{
+	mOutput.Append(static_cast<const char*>(data), size);
+}
+
+inline gep::binary::Decoder::Decoder(std::string_view data)
+{
+	SetInput(data);
+}
+
+inline void gep::binary::Decoder::SetInput(std::string_view data)
+{
+	mCursor = data.data();
+	mEnd = data.data() + data.size();
+}
+
+template<typename Type>
+inline bool gep::binary::Decoder::Decode(Type& item)
+{
+	uint64_t schema;
+	if (!Bytes(&schema, sizeof(schema)) || schema != detail::schema_of<Type>()) return false;
+
+	return Value(item);
+}
+
+template<typename Type>
+inline bool gep::binary::Decoder::Value(Type& item)
+{
+	if constexpr (detail::has_codec<Type>)
+	{
+		return Codec<Type>::decode(*this, item);
+	}
+	else if constexpr (std::is_same_v<Type, bool>)
+	{
+		if (mCursor == mEnd) return false;
+
+		item = *mCursor++ != 0;
+		return true;
+	}
+	else if constexpr (std::is_enum_v<Type>)
+	{
+		std::underlying_type_t<Type> value;
+		if (!Value(value)) return false;
+
+		item = static_cast<Type>(value);
+		return true;
+	}
+	else if constexpr (std::is_integral_v<Type>)
+	{
+		uint64_t value;
+		if (!Varint(value)) return false;
+
+		if constexpr (std::is_signed_v<Type>) item = static_cast<Type>(detail::unzigzag(value));
+		else                                  item = static_cast<Type>(value);
+		return true;
+	}
+	else if constexpr (detail::is_raw<Type>)
+	{
+		return Bytes(&item, sizeof(item));
+	}
+	else if constexpr (detail::is_std_array<Type>::value)
+	{
+		if constexpr (detail::is_block_element<typename Type::value_type>) return Bytes(item.data(), sizeof(item));
+
+		for (auto& element : item)
+		{
+			if (!Value(element)) return false;
+		}
+		return true;
+	}
+	else if constexpr (detail::is_range<Type>)
+	{
+		uint64_t count;
+		if (!Varint(count)) return false;
+
+		using Element = std::ranges::range_value_t<Type>;
+
+		// every element takes at least one byte, so a count past the end of the data is corrupt rather than a huge allocation
+		if (count > GetRemaining()) return false;
+
+		if constexpr (std::ranges::contiguous_range<Type> && detail::is_block_element<Element> && requires { item.resize(count); })
+		{
+			if (count * sizeof(Element) > GetRemaining()) return false;
+
+			item.resize(static_cast<size_t>(count));
+			return Bytes(std::ranges::data(item), static_cast<size_t>(count) * sizeof(Element));
+		}
+		else if constexpr (detail::is_map<Type>)
+		{
+			item.clear();
+			for (uint64_t i = 0; i < count; i++)
+			{
+				typename Type::key_type key{};
+				if (!Value(key) || !Value(item[std::move(key)])) return false;
+			}
+			return true;
+		}
+		else if constexpr (detail::is_set<Type>)
+		{
+			item.clear();
+			for (uint64_t i = 0; i < count; i++)
+			{
+				typename Type::key_type key{};
+				if (!Value(key)) return false;
+
+				item.insert(std::move(key));
+			}
+			return true;
+		}
+		else if constexpr (detail::is_sequence<Type>)
+		{
+			item.clear();
+			if constexpr (requires { item.reserve(count); }) item.reserve(static_cast<size_t>(count));
+
+			for (uint64_t i = 0; i < count; i++)
+			{
+				if (!Value(item.emplace_back())) return false;
+			}
+			return true;
+		}
+		else
+		{
+			static_assert(!sizeof(Type), "this container cannot be decoded");
+			return false;
+		}
+	}
+	else
+	{
+		static_assert(!sizeof(Type), "this type cannot be decoded, mark its fields serializable");
+		return false;
+	}
+}
+
+template<typename First, typename... Rest>
+inline bool gep::binary::Decoder::Fields(First& first, Rest&... rest)
+{
+	if constexpr (detail::is_raw<First>)
+	{
+		return Run(reinterpret_cast<char*>(std::addressof(first)), sizeof(First), rest...);
+	}
+	else
+	{
+		return Value(first) && Fields(rest...);
+	}
+}
+
+template<typename Next, typename... Rest>
+inline bool gep::binary::Decoder::Run(char* begin, size_t size, Next& next, Rest&... rest)
+{
+	if constexpr (detail::is_raw<Next>)
+	{
+		if (reinterpret_cast<char*>(std::addressof(next)) == begin + size) return Run(begin, size + sizeof(Next), rest...);
+	}
+
+	return Bytes(begin, size) && Fields(next, rest...);
+}
+
+inline bool gep::binary::Decoder::Varint(uint64_t& value)
+{
+	// with ten bytes left a varint cannot run off the end, so the loop skips the bounds check
+	if (mEnd - mCursor >= 10)
+	{
+		value = 0;
+		for (int shift = 0; shift < 70; shift += 7)
+		{
+			const uint8_t byte = static_cast<uint8_t>(*mCursor++);
+			value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+			if (!(byte & 0x80)) return true;
+		}
+		return false;
+	}
+
+	value = 0;
+	for (int shift = 0; shift < 70 && mCursor != mEnd; shift += 7)
+	{
+		const uint8_t byte = static_cast<uint8_t>(*mCursor++);
+		value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+		if (!(byte & 0x80)) return true;
+	}
+	return false;
+}
+
+inline bool gep::binary::Decoder::Bytes(void* data, size_t size)
+{
+	if (GetRemaining() < size) return false;
+
+	if (size) std::memcpy(data, mCursor, size);
+	mCursor += size;
+	return true;
+}
+
+inline size_t gep::binary::Decoder::GetRemaining() const
+{
+	return static_cast<size_t>(mEnd - mCursor);
+}
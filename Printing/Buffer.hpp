@@ -0,0 +1,86 @@
+/*****************************************************************//**
+ * \file   Buffer.hpp
+ * \brief  growable output buffer shared by the json and binary writers
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <utility>
+
+namespace gep
+{
+	/////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// growable bytes that keep their memory between writes. unlike std::string growing never fills the
+	/// new memory, so formatting writes straight into the end of the buffer
+	class Buffer
+	{
+	public:
+		// room for at least bytes more, returns where they start. nothing is written until Commit
+		char* Reserve(size_t bytes)
+		{
+			if (mCapacity - mSize < bytes) Grow(bytes);
+			return mData.get() + mSize;
+		}
+
+		// keeps bytes written at the pointer Reserve returned
+		void Commit(size_t bytes)
+		{
+			mSize += bytes;
+		}
+
+		void Append(const char* data, size_t size)
+		{
+			std::memcpy(Reserve(size), data, size);
+			mSize += size;
+		}
+
+		void Push(char c)
+		{
+			*Reserve(1) = c;
+			mSize++;
+		}
+
+		// empties the buffer but keeps its memory for the next write
+		void Clear()
+		{
+			mSize = 0;
+		}
+
+		std::string_view View() const
+		{
+			return std::string_view(mData.get(), mSize);
+		}
+
+		// the bytes written so far, for patching what was reserved earlier. moves whenever the buffer grows
+		char* Data()
+		{
+			return mData.get();
+		}
+
+	private:
+		// at least doubles so appends are amortized constant
+		void Grow(size_t bytes)
+		{
+			size_t capacity = mCapacity ? mCapacity * 2 : 4096;
+			while (capacity - mSize < bytes) capacity *= 2;
+
+			std::unique_ptr<char[]> data(new char[capacity]);
+			if (mSize) std::memcpy(data.get(), mData.get(), mSize);
+
+			mData = std::move(data);
+			mCapacity = capacity;
+		}
+
+	private:
+		std::unique_ptr<char[]> mData;
+		size_t mSize = 0;
+		size_t mCapacity = 0;
+	};
+}
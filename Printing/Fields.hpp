@@ -0,0 +1,91 @@
+/*****************************************************************//**
+ * \file   Fields.hpp
+ * \brief  compile time descriptors of the reflected fields of a class.
+ *         the preprocessor generates a table for every reflected class
+ *         and for_each_field expands over it with a fold expression, so
+ *         every use inlines with no runtime dispatch
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace gep
+{
+	// what a field is reflected for, a field marked by both keywords has both bits.
+	// printable and serializable are macros so the flags cannot share their names
+	inline constexpr uint32_t field_printable    = 1 << 0;
+	inline constexpr uint32_t field_serializable = 1 << 1;
+
+	// one reflected field of Class
+	template <typename Class, typename Member>
+	struct field_descriptor
+	{
+		using class_type  = Class;
+		using member_type = Member;
+
+		std::string_view name;
+		Member Class::* pointer;
+		uint32_t flags;
+
+		constexpr bool is_printable() const { return flags & field_printable; }
+		constexpr bool is_serializable() const { return flags & field_serializable; }
+
+		// the field inside of item
+		constexpr Member& get(Class& item) const { return item.*pointer; }
+		constexpr const Member& get(const Class& item) const { return item.*pointer; }
+	};
+
+	// generated tables build their descriptors with this so Class and Member are always deduced
+	template <typename Class, typename Member>
+	constexpr field_descriptor<Class, Member> make_field(std::string_view name, Member Class::* pointer, uint32_t flags)
+	{
+		return field_descriptor<Class, Member>{ name, pointer, flags };
+	}
+
+	// backend implementation
+	namespace detail
+	{
+		/////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// specialized in the meta file of every reflected class, holds a tuple of field_descriptor named fields
+		/// in declaration order. reflected classes befriend it so the table can point at private members
+		template <typename Type>
+		struct Fields;
+	}
+
+	// true for classes the preprocessor generated a field table for
+	template <typename Type>
+	concept has_fields = requires { detail::Fields<std::remove_cvref_t<Type>>::fields; };
+
+	// the descriptor of every reflected field of Type in declaration order
+	template <typename Type> requires has_fields<Type>
+	constexpr const auto& get_fields()
+	{
+		return detail::Fields<std::remove_cvref_t<Type>>::fields;
+	}
+
+	template <typename Type> requires has_fields<Type>
+	inline constexpr size_t field_count = std::tuple_size_v<std::remove_cvref_t<decltype(get_fields<Type>())>>;
+
+	// calls function(descriptor, value) for every reflected field of item, value keeps the constness of item
+	template <typename Type, typename Function> requires has_fields<Type>
+	constexpr void for_each_field(Type&& item, Function&& function)
+	{
+		std::apply([&](const auto&... descriptors) { (function(descriptors, item.*descriptors.pointer), ...); }, get_fields<Type>());
+	}
+
+	// calls function(descriptor) for every reflected field of Type, for work that needs no object
+	template <typename Type, typename Function> requires has_fields<Type>
+	constexpr void for_each_field(Function&& function)
+	{
+		std::apply([&](const auto&... descriptors) { (function(descriptors), ...); }, get_fields<Type>());
+	}
+}
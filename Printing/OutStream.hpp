@@ -14,6 +14,34 @@
 
 namespace gep
 {
+	// backend implementation
+	namespace detail
+	{
+		// when set every gep stream on the current thread appends to it rather than writing to std::cout
+		inline thread_local std::string* output_capture = nullptr;
+	}
+
+	// redirects gep streams on the current thread into a string for as long as it lives, used to print the output of worker threads in order
+	class capture_output
+	{
+	public:
+		capture_output(std::string& output) : mPrevious(detail::output_capture)
+		{
+			detail::output_capture = &output;
+		}
+
+		~capture_output()
+		{
+			detail::output_capture = mPrevious;
+		}
+
+		capture_output(const capture_output&) = delete;
+		capture_output& operator=(const capture_output&) = delete;
+
+	private:
+		std::string* mPrevious;
+	};
+
 	class streambuf : public std::streambuf
 	{
 	public:
@@ -45,7 +73,14 @@ namespace gep
 
 		virtual int sync() override
 		{
-			std::cout << mColorCode << mBuffer << gep::color::RESET;
+			if (detail::output_capture)
+			{
+				detail::output_capture->append(mColorCode).append(mBuffer).append(gep::color::RESET);
+			}
+			else
+			{
+				std::cout << mColorCode + mBuffer + gep::color::RESET;
+			}
 			mBuffer.clear();
 			return 0;
 		}
@@ -68,7 +103,8 @@ namespace gep
 		gep::streambuf mStreamBuffer;
 	};
 
-	static gep::ostream cout(gep::color::GREEN);  // std::cout but green
-	static gep::ostream cwar(gep::color::YELLOW); // std::cout but yellow
-	static gep::ostream cerr(gep::color::RED);    // std::cerr but red
+	// one of each per thread so lines written by different threads never mix
+	static thread_local gep::ostream cout(gep::color::GREEN);  // std::cout but green
+	static thread_local gep::ostream cwar(gep::color::YELLOW); // std::cout but yellow
+	static thread_local gep::ostream cerr(gep::color::RED);    // std::cerr but red
 }
@@ -1,39 +1,669 @@
 /*****************************************************************//**
  * \file   Serializing.hpp
- * \brief  
- * 
+ * \brief
+ *
  * \author 2018t
  * \date   May 2024
  *********************************************************************/
 
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <string>
-#include <iostream>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GEP_JSON_SSE2
+#endif
+
+#include <simdjson.h>
+
+#include "Buffer.hpp"
 
 namespace gep
 {
 	namespace json
 	{
+		class File;
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// specialized in the meta file of every class with serializable fields. the specialization has a
+		/// static read(file, value, item) template so nested types are looked up when it is first used
+		template <typename Type>
+		struct Reader {};
+
+		// specialized next to Reader with a static write(file, item) that appends the json of item
+		template <typename Type>
+		struct Writer {};
+
 		class File
 		{
 		public:
-			// reads an item from the 
+			// reads the whole file into the padded buffer simdjson parses from, false if it could not be read
+			bool Open(const std::filesystem::path& path);
+
+			// copies json into the padded buffer
+			void Parse(std::string_view json);
+
+			// reads the root of the document into item in one pass, false if the json does not match item
 			template <typename Type>
-			void Read(Type& item) const;
+			bool Read(Type& item);
 
+			// appends the json of item to the output, nothing is allocated once the output has grown to fit
 			template <typename Type>
 			void Write(const Type& item);
+
+			// everything written since the last Clear
+			std::string_view GetOutput() const;
+
+			// empties the output but keeps its memory
+			void Clear();
+
+			// writes the output to path in one call, false if it could not be written
+			bool Save(const std::filesystem::path& path) const;
+
+			/////////////////////////////////////////////////////////////////////////////////////////////////
+			/// reads newline delimited json, one item per line, and hands each item to callback as it is
+			/// read. the file is read in blocks of blockSize cut at the last newline, so memory stays the
+			/// same however long the file is. simdjson finds the documents of the next batch on its own
+			/// thread when threads are enabled. false if the file could not be read or a line does not match
+			template <typename Type, typename Callback>
+			bool ReadLines(const std::filesystem::path& path, Callback&& callback, size_t blockSize = sLineBlockSize);
+
+			// appends every line of the file to items
+			template <typename Type>
+			bool ReadLines(const std::filesystem::path& path, std::vector<Type>& items, size_t blockSize = sLineBlockSize);
+
+			// reads one value into item, the generated readers call it for every field
+			template <typename Type>
+			bool ReadValue(simdjson::ondemand::value value, Type& item);
+
+			// appends one value, the generated writers call it for every field
+			template <typename Type>
+			void WriteValue(const Type& item);
+
+			// appends text as a quoted json string
+			void WriteString(std::string_view text);
+
+			// appends json that is already formatted, the size of a literal is known at compile time
+			template <size_t Size>
+			void WriteLiteral(const char (&literal)[Size])
+			{
+				mOutput.Append(literal, Size - 1);
+			}
+
+			// how much of a newline delimited file is held at once, documents are found in batches of a quarter of it
+			static constexpr size_t sLineBlockSize = 4 * simdjson::ondemand::DEFAULT_BATCH_SIZE;
+
+		private:
+			simdjson::ondemand::parser mParser;
+
+			simdjson::padded_string mJson;
+
+			gep::Buffer mOutput;
+
+			friend class LineWriter;
 		};
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// writes newline delimited json, one item per line. lines collect in the output of a file and are
+		/// written out whenever blockSize bytes are waiting, so any number of items can be written with one
+		/// block of memory
+		class LineWriter
+		{
+		public:
+			explicit LineWriter(size_t blockSize = File::sLineBlockSize) : mBlockSize(blockSize) {}
+
+			// flushes what is left
+			~LineWriter() { Close(); }
+
+			// creates or truncates the file at path, false if it could not be opened
+			bool Open(const std::filesystem::path& path);
+
+			// appends item as one line, false once writing to the file has failed
+			template <typename Type>
+			bool Write(const Type& item);
+
+			// appends every item of items as its own line
+			template <typename Range>
+			bool WriteAll(const Range& items);
+
+			// writes what is left and closes the file, false if any write failed
+			bool Close();
+
+		private:
+			// writes the waiting lines to the file
+			bool Flush();
+
+			File mFile;
+			std::ofstream mStream;
+			size_t mBlockSize;
+		};
+
+		// backend implementation
+		namespace detail
+		{
+			/////////////////////////////////////////////////////////////////////////////////////////////////
+			/// hash of an object key, the preprocessor searches for a seed that gives every field of a class
+			/// its own bucket so a key is matched with one switch and one compare
+			inline uint64_t key_hash(std::string_view key, uint64_t seed)
+			{
+				uint64_t hash = seed ^ (key.size() * 0x9E3779B97F4A7C15ull);
+
+				size_t i = 0;
+				for (; i + 8 <= key.size(); i += 8)
+				{
+					uint64_t word;
+					std::memcpy(&word, key.data() + i, sizeof(word));
+
+					hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+					hash ^= hash >> 32;
+				}
+
+				uint64_t tail = 0;
+				std::memcpy(&tail, key.data() + i, key.size() - i);
+
+				hash = (hash ^ tail) * 0xC4CEB9FE1A85EC53ull;
+				return hash ^ (hash >> 29);
+			}
+
+			// true for the bytes json requires to be escaped inside of a string
+			inline bool needs_escape(char c)
+			{
+				return static_cast<unsigned char>(c) < 0x20 || c == '"' || c == '\\';
+			}
+
+			// the length of the run at the start of text that can be copied as it is, checked 16 bytes at a time where sse2 is available
+			inline size_t clean_prefix(const char* text, size_t size)
+			{
+				size_t i = 0;
+
+#ifdef GEP_JSON_SSE2
+				const __m128i quote = _mm_set1_epi8('"');
+				const __m128i backslash = _mm_set1_epi8('\\');
+				const __m128i control = _mm_set1_epi8(0x1F);
+
+				for (; i + 16 <= size; i += 16)
+				{
+					const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+
+					// a byte is a control character when the unsigned min with 0x1F leaves it unchanged
+					const __m128i isControl = _mm_cmpeq_epi8(_mm_min_epu8(bytes, control), bytes);
+					const __m128i isSpecial = _mm_or_si128(_mm_cmpeq_epi8(bytes, quote), _mm_cmpeq_epi8(bytes, backslash));
+
+					const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(isControl, isSpecial)));
+					if (mask) return i + std::countr_zero(mask);
+				}
+#endif
+
+				while (i < size && !needs_escape(text[i])) i++;
+				return i;
+			}
+
+			template <typename Type>
+			concept has_writer = requires(File& file, const Type& item) { Writer<Type>::write(file, item); };
+
+			template <typename Type>
+			concept is_range = requires(const Type& range) { std::begin(range); std::end(range); };
+
+			template <typename Type>
+			concept has_reader = requires(File& file, simdjson::ondemand::value value, Type& item) { Reader<Type>::read(file, value, item); };
+
+			template <typename Type>
+			struct is_std_array : std::false_type {};
+
+			template <typename Type, size_t Size>
+			struct is_std_array<std::array<Type, Size>> : std::true_type {};
+
+			// maps keyed by strings are json objects
+			template <typename Type>
+			concept is_object_map = requires { typename Type::key_type; typename Type::mapped_type; }
+				&& std::is_constructible_v<typename Type::key_type, std::string_view>;
+
+			template <typename Type>
+			concept is_set = requires(Type& set, typename Type::key_type key) { set.insert(std::move(key)); } && !requires { typename Type::mapped_type; };
+
+			template <typename Type>
+			concept is_sequence = requires(Type& sequence) { sequence.emplace_back(); sequence.clear(); };
+		}
 	}
 }
 
+inline bool gep::json::File::Open(const std::filesystem::path& path)
+{
+	return !simdjson::padded_string::load(path.string()).get(mJson);
+}
+
+inline void gep::json::File::Parse(std::string_view json)
+{
+	mJson = simdjson::padded_string(json);
+}
+
 template<typename Type>
-inline void gep::json::File::Read(Type& item) const
+inline bool gep::json::File::Read(Type& item)
 {
-	std::cout << "attempting to read an unknown object" << std::endl;
+	simdjson::ondemand::document document;
+	if (mParser.iterate(mJson).get(document)) return false;
+
+	simdjson::ondemand::value root;
+	if (document.get_value().get(root)) return false;
+
+	return ReadValue(root, item);
+}
+
+template<typename Type>
+inline bool gep::json::File::ReadValue(simdjson::ondemand::value value, Type& item)
+{
+	if constexpr (detail::has_reader<Type>)
+	{
+		return Reader<Type>::read(*this, value, item);
+	}
+	else if constexpr (std::is_same_v<Type, bool>)
+	{
+		return !value.get_bool().get(item);
+	}
+	else if constexpr (std::is_enum_v<Type>)
+	{
+		// stored as its underlying number, the same as the binary codec
+		std::underlying_type_t<Type> number;
+		if (!ReadValue(value, number)) return false;
+
+		item = static_cast<Type>(number);
+		return true;
+	}
+	else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+	{
+		int64_t number;
+		if (value.get_int64().get(number)) return false;
+		if (number < std::numeric_limits<Type>::min() || number > std::numeric_limits<Type>::max()) return false;
+
+		item = static_cast<Type>(number);
+		return true;
+	}
+	else if constexpr (std::is_integral_v<Type>)
+	{
+		uint64_t number;
+		if (value.get_uint64().get(number)) return false;
+		if (number > std::numeric_limits<Type>::max()) return false;
+
+		item = static_cast<Type>(number);
+		return true;
+	}
+	else if constexpr (std::is_floating_point_v<Type>)
+	{
+		double number;
+		if (value.get_double().get(number)) return false;
+
+		item = static_cast<Type>(number);
+		return true;
+	}
+	else if constexpr (std::is_same_v<Type, std::string>)
+	{
+		std::string_view text;
+		if (value.get_string().get(text)) return false;
+
+		item.assign(text);
+		return true;
+	}
+	else if constexpr (detail::is_object_map<Type>)
+	{
+		simdjson::ondemand::object object;
+		if (value.get_object().get(object)) return false;
+
+		item.clear();
+		for (auto result : object)
+		{
+			simdjson::ondemand::field field;
+			std::string_view key;
+			if (std::move(result).get(field) || field.unescaped_key().get(key)) return false;
+
+			if (!ReadValue(field.value(), item[typename Type::key_type(key)])) return false;
+		}
+		return true;
+	}
+	else if constexpr (detail::is_std_array<Type>::value)
+	{
+		simdjson::ondemand::array array;
+		if (value.get_array().get(array)) return false;
+
+		// extra elements are an error, missing ones keep their value
+		size_t index = 0;
+		for (auto element : array)
+		{
+			simdjson::ondemand::value elementValue;
+			if (index >= item.size() || std::move(element).get(elementValue) || !ReadValue(elementValue, item[index])) return false;
+			index++;
+		}
+		return true;
+	}
+	else if constexpr (detail::is_set<Type>)
+	{
+		simdjson::ondemand::array array;
+		if (value.get_array().get(array)) return false;
+
+		item.clear();
+		for (auto element : array)
+		{
+			simdjson::ondemand::value elementValue;
+			typename Type::key_type key{};
+			if (std::move(element).get(elementValue) || !ReadValue(elementValue, key)) return false;
+
+			item.insert(std::move(key));
+		}
+		return true;
+	}
+	else if constexpr (detail::is_sequence<Type>)
+	{
+		simdjson::ondemand::array array;
+		if (value.get_array().get(array)) return false;
+
+		item.clear();
+		for (auto element : array)
+		{
+			simdjson::ondemand::value elementValue;
+			if (std::move(element).get(elementValue) || !ReadValue(elementValue, item.emplace_back())) return false;
+		}
+		return true;
+	}
+	else
+	{
+		static_assert(!sizeof(Type), "this type cannot be read from json, mark its fields serializable");
+		return false;
+	}
 }
 
 template<typename Type>
 inline void gep::json::File::Write(const Type& item)
 {
-	std::cout << "attempting to write an unknown object" << std::endl;
+	WriteValue(item);
+}
+
+inline std::string_view gep::json::File::GetOutput() const
+{
+	return mOutput.View();
+}
+
+inline void gep::json::File::Clear()
+{
+	mOutput.Clear();
+}
+
+inline bool gep::json::File::Save(const std::filesystem::path& path) const
+{
+	const std::string_view output = mOutput.View();
+
+	std::ofstream file(path, std::ios::binary);
+	file.write(output.data(), static_cast<std::streamsize>(output.size()));
+
+	return static_cast<bool>(file.flush());
+}
+
+template<typename Type>
+inline void gep::json::File::WriteValue(const Type& item)
+{
+	if constexpr (detail::has_writer<Type>)
+	{
+		Writer<Type>::write(*this, item);
+	}
+	else if constexpr (std::is_same_v<Type, bool>)
+	{
+		if (item) WriteLiteral("true");
+		else      WriteLiteral("false");
+	}
+	else if constexpr (std::is_enum_v<Type>)
+	{
+		WriteValue(static_cast<std::underlying_type_t<Type>>(item));
+	}
+	else if constexpr (std::is_integral_v<Type>)
+	{
+		char* out = mOutput.Reserve(24);
+		mOutput.Commit(std::to_chars(out, out + 24, item).ptr - out);
+	}
+	else if constexpr (std::is_floating_point_v<Type>)
+	{
+		// json has no infinity or nan
+		if (!std::isfinite(item))
+		{
+			WriteLiteral("null");
+			return;
+		}
+
+		// the shortest text that reads back as the same value
+		char* out = mOutput.Reserve(32);
+		mOutput.Commit(std::to_chars(out, out + 32, item).ptr - out);
+	}
+	else if constexpr (std::is_convertible_v<const Type&, std::string_view>)
+	{
+		WriteString(item);
+	}
+	else if constexpr (detail::is_object_map<Type>)
+	{
+		mOutput.Push('{');
+
+		bool isFirst = true;
+		for (const auto& [key, value] : item)
+		{
+			if (!isFirst) mOutput.Push(',');
+			isFirst = false;
+
+			WriteString(key);
+			mOutput.Push(':');
+			WriteValue(value);
+		}
+
+		mOutput.Push('}');
+	}
+	else if constexpr (detail::is_range<Type>)
+	{
+		mOutput.Push('[');
+
+		bool isFirst = true;
+		for (const auto& element : item)
+		{
+			if (!isFirst) mOutput.Push(',');
+			isFirst = false;
+
+			WriteValue(element);
+		}
+
+		mOutput.Push(']');
+	}
+	else
+	{
+		static_assert(!sizeof(Type), "this type cannot be written to json, mark its fields serializable");
+	}
+}
+
+inline void gep::json::File::WriteString(std::string_view text)
+{
+	mOutput.Push('"');
+
+	while (!text.empty())
+	{
+		// clean runs are copied whole, only the byte that stopped the scan is looked at on its own
+		const size_t clean = detail::clean_prefix(text.data(), text.size());
+		if (clean) mOutput.Append(text.data(), clean);
+		if (clean == text.size()) break;
+
+		const char c = text[clean];
+		switch (c)
+		{
+		case '"':  WriteLiteral("\\\""); break;
+		case '\\': WriteLiteral("\\\\"); break;
+		case '\n': WriteLiteral("\\n"); break;
+		case '\r': WriteLiteral("\\r"); break;
+		case '\t': WriteLiteral("\\t"); break;
+		case '\b': WriteLiteral("\\b"); break;
+		case '\f': WriteLiteral("\\f"); break;
+		default:
+		{
+			static constexpr char sHex[] = "0123456789abcdef";
+
+			char* out = mOutput.Reserve(6);
+			std::memcpy(out, "\\u00", 4);
+			out[4] = sHex[static_cast<unsigned char>(c) >> 4];
+			out[5] = sHex[static_cast<unsigned char>(c) & 0xF];
+			mOutput.Commit(6);
+			break;
+		}
+		}
+
+		text.remove_prefix(clean + 1);
+	}
+
+	mOutput.Push('"');
+}
+
+template<typename Type, typename Callback>
+inline bool gep::json::File::ReadLines(const std::filesystem::path& path, Callback&& callback, size_t blockSize)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file) return false;
+
+	size_t capacity = std::max(blockSize, simdjson::ondemand::MINIMAL_BATCH_SIZE);
+	std::unique_ptr<char[]> block(new char[capacity + simdjson::SIMDJSON_PADDING]);
+
+	// bytes of an unfinished line carried over from the last block
+	size_t size = 0;
+	bool isEnd = false;
+
+	while (!isEnd)
+	{
+		file.read(block.get() + size, static_cast<std::streamsize>(capacity - size));
+		size += static_cast<size_t>(file.gcount());
+
+		if (file.bad()) return false;
+		isEnd = file.eof();
+
+		// only whole lines are parsed, the last block ends wherever the file does
+		size_t end = size;
+		size_t longest = 0;
+		for (size_t start = 0; start < size;)
+		{
+			const char* newline = static_cast<const char*>(std::memchr(block.get() + start, '\n', size - start));
+			if (!newline)
+			{
+				if (!isEnd) end = start;
+				longest = std::max(longest, size - start);
+				break;
+			}
+
+			const size_t next = static_cast<size_t>(newline - block.get()) + 1;
+			longest = std::max(longest, next - start);
+			start = next;
+		}
+
+		// one line fills the whole block, it is grown so the rest of the line fits
+		if (end == 0 && !isEnd)
+		{
+			std::unique_ptr<char[]> grown(new char[capacity * 2 + simdjson::SIMDJSON_PADDING]);
+			std::memcpy(grown.get(), block.get(), size);
+
+			block = std::move(grown);
+			capacity *= 2;
+			continue;
+		}
+
+		if (end)
+		{
+			// a batch has to hold the longest document, otherwise the quarter block lets the next batch be
+			// indexed while this one is read
+			const size_t batchSize = std::max({ capacity / 4, longest + 1, simdjson::ondemand::MINIMAL_BATCH_SIZE });
+
+			simdjson::ondemand::document_stream stream;
+			if (mParser.iterate_many(block.get(), end, batchSize).get(stream)) return false;
+
+			for (auto result : stream)
+			{
+				simdjson::ondemand::document_reference document;
+				if (std::move(result).get(document)) return false;
+
+				simdjson::ondemand::value root;
+				if (document.get_value().get(root)) return false;
+
+				Type item{};
+				if (!ReadValue(root, item)) return false;
+
+				callback(std::move(item));
+			}
+
+			if (stream.truncated_bytes()) return false;
+		}
+
+		std::memmove(block.get(), block.get() + end, size - end);
+		size -= end;
+	}
+
+	return true;
+}
+
+template<typename Type>
+inline bool gep::json::File::ReadLines(const std::filesystem::path& path, std::vector<Type>& items, size_t blockSize)
+{
+	return ReadLines<Type>(path, [&items](Type&& item) { items.push_back(std::move(item)); }, blockSize);
+}
+
+inline bool gep::json::LineWriter::Open(const std::filesystem::path& path)
+{
+	Close();
+	mFile.Clear();
+
+	mStream.clear();
+	mStream.open(path, std::ios::binary | std::ios::trunc);
+	return mStream.is_open();
+}
+
+template<typename Type>
+inline bool gep::json::LineWriter::Write(const Type& item)
+{
+	mFile.WriteValue(item);
+	mFile.mOutput.Push('\n');
+
+	if (mFile.mOutput.View().size() >= mBlockSize) return Flush();
+	return static_cast<bool>(mStream);
+}
+
+template<typename Range>
+inline bool gep::json::LineWriter::WriteAll(const Range& items)
+{
+	for (const auto& item : items)
+	{
+		if (!Write(item)) return false;
+	}
+
+	return true;
+}
+
+inline bool gep::json::LineWriter::Close()
+{
+	if (!mStream.is_open()) return true;
+
+	const bool isWritten = Flush() && mStream.flush();
+	mStream.close();
+
+	return isWritten;
+}
+
+inline bool gep::json::LineWriter::Flush()
+{
+	const std::string_view output = mFile.GetOutput();
+	mStream.write(output.data(), static_cast<std::streamsize>(output.size()));
+
+	mFile.Clear();
+	return static_cast<bool>(mStream);
 }
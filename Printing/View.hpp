@@ -0,0 +1,457 @@
+/*****************************************************************//**
+ * \file   View.hpp
+ * \brief  zero copy views over serialized objects. every object is a
+ *         table of slots at offsets known at compile time, fixed size
+ *         fields are stored in their slot and everything else holds the
+ *         offset of its data, so a view reads fields straight out of a
+ *         mapped file without decoding anything first
+ *
+ * \author 2018t
+ * \date   October 2026
+ *********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "Binary.hpp"
+#include "Buffer.hpp"
+
+namespace gep
+{
+	namespace binary
+	{
+		class ViewWriter;
+
+		template <typename Element>
+		class ListView;
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// specialized in the meta file of every class with serializable fields as a TableView with one
+		/// accessor per field. the specializations are partial, so the table of a class is only laid out once
+		/// something views it and fields that cannot be viewed cost nothing until then
+		template <typename Type>
+		struct View;
+
+		// backend implementation
+		namespace detail
+		{
+			inline constexpr size_t align_up(size_t offset, size_t alignment)
+			{
+				return (offset + alignment - 1) / alignment * alignment;
+			}
+
+			// unaligned loads and stores, slots are only aligned relative to the start of the buffer
+			template <typename Type>
+			inline Type load(const char* at)
+			{
+				Type value;
+				std::memcpy(&value, at, sizeof(Type));
+				return value;
+			}
+
+			template <typename Type>
+			struct member_type;
+
+			template <typename Class, typename Member>
+			struct member_type<Member Class::*> { using type = Member; };
+
+			// the meta file generates a View next to every codec. the codec is checked so View itself is not instantiated
+			template <typename Type>
+			concept has_table = has_codec<Type>;
+
+			template <typename Type>
+			concept is_pair = requires { typename Type::first_type; typename Type::second_type; };
+
+			// stored inside of its slot, pointers would point into the process that wrote them
+			template <typename Type>
+			concept is_fixed = std::is_trivially_copyable_v<Type> && !std::is_pointer_v<Type> && !std::is_member_pointer_v<Type>
+				&& !has_table<Type> && !is_range<Type> && !is_pair<Type>;
+
+			/////////////////////////////////////////////////////////////////////////////////////////////////
+			/// how a value of Type is laid out in a table. size and align describe its slot and view_type is
+			/// what reading the slot returns
+			template <typename Type>
+			struct view_slot
+			{
+				static_assert(!sizeof(Type), "this type cannot be viewed, mark its fields serializable");
+			};
+
+			template <typename Type> requires is_fixed<Type>
+			struct view_slot<Type>
+			{
+				static constexpr size_t size = sizeof(Type);
+				static constexpr size_t align = alignof(Type);
+
+				using view_type = Type;
+
+				static view_type read(const char*, const char* slot)
+				{
+					return load<Type>(slot);
+				}
+			};
+
+			// the slot holds the offset of the table of the nested object
+			template <typename Type> requires has_table<Type>
+			struct view_slot<Type>
+			{
+				static constexpr size_t size = sizeof(uint64_t);
+				static constexpr size_t align = alignof(uint64_t);
+
+				using view_type = View<Type>;
+
+				static view_type read(const char* base, const char* slot)
+				{
+					return view_type(base, load<uint64_t>(slot));
+				}
+			};
+
+			// both halves are stored inline, which is how map entries are kept
+			template <typename Type> requires is_pair<Type>
+			struct view_slot<Type>
+			{
+				using First = view_slot<std::remove_const_t<typename Type::first_type>>;
+				using Second = view_slot<typename Type::second_type>;
+
+				static constexpr size_t second = align_up(First::size, Second::align);
+				static constexpr size_t align = std::max(First::align, Second::align);
+				static constexpr size_t size = align_up(second + Second::size, align);
+
+				using view_type = std::pair<typename First::view_type, typename Second::view_type>;
+
+				static view_type read(const char* base, const char* slot)
+				{
+					return view_type(First::read(base, slot), Second::read(base, slot + second));
+				}
+			};
+
+			/////////////////////////////////////////////////////////////////////////////////////////////////
+			/// the slot holds the offset of a count followed by the elements. strings are string_views, fixed
+			/// size elements stored back to back are spans and anything else is a list of slots
+			template <typename Type> requires is_range<Type> && (!is_fixed<Type>)
+			struct view_slot<Type>
+			{
+				using Element = std::remove_cvref_t<std::ranges::range_value_t<Type>>;
+
+				static constexpr size_t size = sizeof(uint64_t);
+				static constexpr size_t align = alignof(uint64_t);
+
+				static constexpr bool is_string = requires { typename Type::traits_type; };
+				static constexpr bool is_span = std::ranges::contiguous_range<Type> && is_fixed<Element>;
+
+				using view_type = std::conditional_t<is_string, std::basic_string_view<Element>,
+					std::conditional_t<is_span, std::span<const Element>, ListView<Element>>>;
+
+				// where the elements start, the count is always 8 bytes before the first alignment
+				static constexpr size_t element_align = is_span ? alignof(Element) : view_slot<Element>::align;
+
+				static view_type read(const char* base, const char* slot)
+				{
+					const uint64_t offset = load<uint64_t>(slot);
+					const uint64_t count = load<uint64_t>(base + offset);
+					const char* elements = base + align_up(offset + sizeof(uint64_t), element_align);
+
+					if constexpr (is_string || is_span) return view_type(reinterpret_cast<const Element*>(elements), static_cast<size_t>(count));
+					else                                return view_type(base, elements, static_cast<size_t>(count));
+				}
+			};
+		}
+
+		// what reading a Type out of a view returns
+		template <typename Type>
+		using view_of = typename detail::view_slot<Type>::view_type;
+
+		// the elements of a container that could not be a span, each one read from its slot as it is accessed
+		template <typename Element>
+		class ListView
+		{
+		public:
+			using Slot = detail::view_slot<Element>;
+			using value_type = typename Slot::view_type;
+
+			static constexpr size_t sStride = detail::align_up(Slot::size, Slot::align);
+
+			class iterator
+			{
+			public:
+				using value_type = typename Slot::view_type;
+				using difference_type = std::ptrdiff_t;
+
+				iterator() = default;
+				iterator(const ListView* list, size_t index) : mList(list), mIndex(index) {}
+
+				value_type operator*() const { return (*mList)[mIndex]; }
+				iterator& operator++() { mIndex++; return *this; }
+				iterator operator++(int) { iterator copy = *this; mIndex++; return copy; }
+				bool operator==(const iterator& other) const { return mIndex == other.mIndex; }
+
+			private:
+				const ListView* mList = nullptr;
+				size_t mIndex = 0;
+			};
+
+			ListView() = default;
+			ListView(const char* base, const char* slots, size_t count) : mBase(base), mSlots(slots), mCount(count) {}
+
+			size_t size() const { return mCount; }
+			bool empty() const { return mCount == 0; }
+
+			value_type operator[](size_t index) const
+			{
+				return Slot::read(mBase, mSlots + index * sStride);
+			}
+
+			iterator begin() const { return iterator(this, 0); }
+			iterator end() const { return iterator(this, mCount); }
+
+		private:
+			const char* mBase = nullptr;
+			const char* mSlots = nullptr;
+			size_t mCount = 0;
+		};
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// the view of one object of Class. the meta file derives View<Class> from it with one accessor per
+		/// field, Members are the serializable fields in declaration order and each gets a slot in that order
+		template <typename Class, auto... Members>
+		class TableView
+		{
+		public:
+			using Types = std::tuple<typename detail::member_type<decltype(Members)>::type...>;
+
+			// bytes from the start of the table to the slot of every field
+			static constexpr std::array<size_t, sizeof...(Members)> sOffsets = []()
+			{
+				std::array<size_t, sizeof...(Members)> offsets{};
+				size_t offset = 0;
+				size_t index = 0;
+
+				((offset = detail::align_up(offset, detail::view_slot<typename detail::member_type<decltype(Members)>::type>::align),
+					offsets[index++] = offset,
+					offset += detail::view_slot<typename detail::member_type<decltype(Members)>::type>::size), ...);
+
+				return offsets;
+			}();
+
+			// tables start 8 byte aligned so every slot inside of them is aligned
+			static constexpr size_t sTableSize = []()
+			{
+				size_t size = 0;
+				((size = detail::align_up(size, detail::view_slot<typename detail::member_type<decltype(Members)>::type>::align)
+					+ detail::view_slot<typename detail::member_type<decltype(Members)>::type>::size), ...);
+
+				return detail::align_up(size, 8);
+			}();
+
+			TableView() = default;
+			TableView(const char* base, uint64_t offset) : mBase(base), mTable(base + offset) {}
+
+			// false for a view that was never pointed at a table
+			bool is_valid() const { return mTable != nullptr; }
+
+			// fills the table at offset with the fields of item, their data is appended after it
+			static void write(ViewWriter& writer, const Class& item, uint64_t offset);
+
+		protected:
+			template <size_t Index>
+			view_of<std::tuple_element_t<Index, Types>> Get() const
+			{
+				return detail::view_slot<std::tuple_element_t<Index, Types>>::read(mBase, mTable + sOffsets[Index]);
+			}
+
+		private:
+			const char* mBase = nullptr;
+			const char* mTable = nullptr;
+		};
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// lays objects out as tables for views to read. the output starts with a header holding the schema
+		/// of the root type followed by the slot of the root
+		class ViewWriter
+		{
+		public:
+			// appends a whole buffer holding item, clear first to write another one
+			template <typename Type>
+			void Write(const Type& item);
+
+			std::string_view GetOutput() const;
+
+			// empties the output but keeps its memory
+			void Clear();
+
+			bool Save(const std::filesystem::path& path) const;
+
+			// stores item into the slot at offset, appending whatever the slot points at
+			template <typename Type>
+			void WriteSlot(const Type& item, uint64_t offset);
+
+		private:
+			// appends size zeroed bytes at the next multiple of alignment and returns their offset
+			uint64_t Allocate(size_t size, size_t alignment);
+
+			// appends the count and elements of a container and returns the offset of the count
+			template <typename Type>
+			uint64_t WriteRange(const Type& range);
+
+		private:
+			gep::Buffer mOutput;
+		};
+
+		struct ViewHeader
+		{
+			char mMagic[4];
+			uint32_t mVersion;
+			uint64_t mSchema;
+		};
+
+		// changes whenever the layout of a table changes
+		inline constexpr uint32_t sViewVersion = 1;
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// points view at the root of data, which must stay alive and 8 byte aligned. only the header is
+		/// checked so opening costs nothing no matter how big the data is, the data must come from ViewWriter
+		template <typename Type>
+		bool get_view(std::string_view data, view_of<Type>& view);
+	}
+}
+
+template<typename Class, auto... Members>
+inline void gep::binary::TableView<Class, Members...>::write(ViewWriter& writer, const Class& item, uint64_t offset)
+{
+	[&]<size_t... Indexes>(std::index_sequence<Indexes...>)
+	{
+		(writer.WriteSlot(item.*Members, offset + sOffsets[Indexes]), ...);
+	}(std::make_index_sequence<sizeof...(Members)>());
+}
+
+template<typename Type>
+inline void gep::binary::ViewWriter::Write(const Type& item)
+{
+	const ViewHeader header = { { 'G', 'E', 'P', 'V' }, sViewVersion, detail::schema_of<Type>() };
+
+	const uint64_t offset = Allocate(sizeof(header), 8);
+	std::memcpy(mOutput.Data() + offset, &header, sizeof(header));
+
+	WriteSlot(item, Allocate(detail::view_slot<Type>::size, detail::view_slot<Type>::align));
+}
+
+inline std::string_view gep::binary::ViewWriter::GetOutput() const
+{
+	return mOutput.View();
+}
+
+inline void gep::binary::ViewWriter::Clear()
+{
+	mOutput.Clear();
+}
+
+inline bool gep::binary::ViewWriter::Save(const std::filesystem::path& path) const
+{
+	const std::string_view output = mOutput.View();
+
+	std::ofstream file(path, std::ios::binary);
+	file.write(output.data(), static_cast<std::streamsize>(output.size()));
+
+	return static_cast<bool>(file.flush());
+}
+
+template<typename Type>
+inline void gep::binary::ViewWriter::WriteSlot(const Type& item, uint64_t offset)
+{
+	if constexpr (detail::is_fixed<Type>)
+	{
+		std::memcpy(mOutput.Data() + offset, &item, sizeof(Type));
+	}
+	else if constexpr (detail::is_pair<Type>)
+	{
+		WriteSlot(item.first, offset);
+		WriteSlot(item.second, offset + detail::view_slot<Type>::second);
+	}
+	else
+	{
+		// the data goes after everything written so far, the output may move so the slot is found again afterwards
+		uint64_t data;
+		if constexpr (detail::has_table<Type>)
+		{
+			data = Allocate(View<Type>::sTableSize, 8);
+			View<Type>::write(*this, item, data);
+		}
+		else
+		{
+			data = WriteRange(item);
+		}
+
+		std::memcpy(mOutput.Data() + offset, &data, sizeof(data));
+	}
+}
+
+inline uint64_t gep::binary::ViewWriter::Allocate(size_t size, size_t alignment)
+{
+	const size_t padding = detail::align_up(mOutput.View().size(), alignment) - mOutput.View().size();
+
+	char* out = mOutput.Reserve(padding + size);
+	std::memset(out, 0, padding + size);
+	mOutput.Commit(padding + size);
+
+	return mOutput.View().size() - size;
+}
+
+template<typename Type>
+inline uint64_t gep::binary::ViewWriter::WriteRange(const Type& range)
+{
+	using Slot = detail::view_slot<Type>;
+	using Element = typename Slot::Element;
+
+	const uint64_t count = static_cast<uint64_t>(std::ranges::distance(range));
+
+	const uint64_t offset = Allocate(sizeof(count), 8);
+	std::memcpy(mOutput.Data() + offset, &count, sizeof(count));
+
+	if constexpr (Slot::is_string || Slot::is_span)
+	{
+		const uint64_t elements = Allocate(static_cast<size_t>(count) * sizeof(Element), Slot::element_align);
+		if (count) std::memcpy(mOutput.Data() + elements, std::ranges::data(range), static_cast<size_t>(count) * sizeof(Element));
+	}
+	else
+	{
+		// every slot is reserved first so the elements stay contiguous, then each one appends its own data
+		const uint64_t slots = Allocate(static_cast<size_t>(count) * ListView<Element>::sStride, Slot::element_align);
+
+		uint64_t slot = slots;
+		for (const auto& element : range)
+		{
+			WriteSlot(element, slot);
+			slot += ListView<Element>::sStride;
+		}
+	}
+
+	return offset;
+}
+
+template<typename Type>
+inline bool gep::binary::get_view(std::string_view data, view_of<Type>& view)
+{
+	using Slot = detail::view_slot<Type>;
+
+	const size_t root = detail::align_up(sizeof(ViewHeader), Slot::align);
+	if (data.size() < root + Slot::size || reinterpret_cast<uintptr_t>(data.data()) % 8 != 0) return false;
+
+	const ViewHeader header = detail::load<ViewHeader>(data.data());
+	if (std::memcmp(header.mMagic, "GEPV", 4) != 0 || header.mVersion != sViewVersion || header.mSchema != detail::schema_of<Type>()) return false;
+
+	view = Slot::read(data.data(), data.data() + root);
+	return true;
+}